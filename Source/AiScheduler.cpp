@@ -0,0 +1,213 @@
+#include "AiScheduler.h"
+
+static double nowMs() { return juce::Time::getMillisecondCounterHiRes(); }
+
+AiScheduler::AiScheduler()
+    : juce::Thread("KeroAiScheduler")
+{
+    lastRefill = nowMs();
+    startThread(juce::Thread::Priority::low);
+}
+
+AiScheduler::~AiScheduler()
+{
+    std::deque<Job> dropped;
+    {
+        const juce::ScopedLock sl(lock);
+        dropped.swap(queue);
+        if (runningCancelled != nullptr) runningCancelled->store(true);
+        if (runningStream != nullptr)    runningStream->cancel();
+    }
+    for (auto& job : dropped) finish(job, Status::cancelled, 0);
+
+    signalThreadShouldExit();
+    notify();
+    stopThread(-1);
+
+    // A retry may have been queued while the worker was finishing.
+    for (auto& job : queue) finish(job, Status::cancelled, 0);
+}
+
+// ── Submission ────────────────────────────────────────────────────────────────
+bool AiScheduler::submit(Request request)
+{
+    Job job;
+    job.request   = std::move(request);
+    job.notBefore = nowMs() + COALESCE_MS;
+
+    std::vector<Job> replaced;
+    {
+        const juce::ScopedLock sl(lock);
+
+        if (runningOwner == job.request.owner && runningCancelled != nullptr)
+        {
+            runningCancelled->store(true);
+            if (runningStream != nullptr) runningStream->cancel();
+        }
+
+        auto it = std::find_if(queue.begin(), queue.end(),
+                               [&](const Job& j) { return j.request.owner == job.request.owner; });
+        if (it != queue.end())
+        {
+            replaced.push_back(std::move(*it));
+            *it = std::move(job);
+        }
+        else if ((int)queue.size() >= MAX_QUEUE)
+        {
+            return false;
+        }
+        else
+        {
+            queue.push_back(std::move(job));
+        }
+    }
+
+    for (auto& j : replaced) finish(j, Status::cancelled, 0);
+    notify();
+    return true;
+}
+
+void AiScheduler::cancel(const void* owner)
+{
+    std::vector<Job> dropped;
+    {
+        const juce::ScopedLock sl(lock);
+
+        for (auto it = queue.begin(); it != queue.end();)
+        {
+            if (it->request.owner == owner) { dropped.push_back(std::move(*it)); it = queue.erase(it); }
+            else ++it;
+        }
+
+        if (runningOwner == owner && runningCancelled != nullptr)
+        {
+            runningCancelled->store(true);
+            if (runningStream != nullptr) runningStream->cancel();
+        }
+    }
+    for (auto& job : dropped) finish(job, Status::cancelled, 0);
+}
+
+void AiScheduler::finish(Job& job, Status status, int httpStatus)
+{
+    if (job.request.onFinished) job.request.onFinished(status, httpStatus);
+}
+
+// ── Worker ────────────────────────────────────────────────────────────────────
+void AiScheduler::run()
+{
+    while (!threadShouldExit())
+    {
+        Job job;
+        const int waitMs = takeNext(job);
+        if (waitMs > 0) { wait(waitMs); continue; }
+        execute(std::move(job));
+    }
+}
+
+int AiScheduler::takeNext(Job& job)
+{
+    const juce::ScopedLock sl(lock);
+    const double now = nowMs();
+
+    tokens     = juce::jmin(RATE_BURST, tokens + (now - lastRefill) * 0.001 * RATE_PER_SECOND);
+    lastRefill = now;
+    const double tokenDue = tokens >= 1.0 ? now : now + (1.0 - tokens) / RATE_PER_SECOND * 1000.0;
+
+    // Requests to local servers skip the token bucket.
+    auto ready = queue.end();
+    double nextDue = now + 1000.0;
+    for (auto it = queue.begin(); it != queue.end(); ++it)
+    {
+        const double due = it->request.rateLimited ? juce::jmax(it->notBefore, tokenDue) : it->notBefore;
+        if (due <= now) { ready = it; break; }
+        nextDue = juce::jmin(nextDue, due);
+    }
+    if (ready == queue.end())
+        return juce::jmax(1, (int)std::ceil(nextDue - now));
+
+    if (ready->request.rateLimited) tokens -= 1.0;
+    job = std::move(*ready);
+    queue.erase(ready);
+    runningOwner     = job.request.owner;
+    runningCancelled = job.cancelled;
+    return 0;
+}
+
+void AiScheduler::execute(Job job)
+{
+    const double deadline = nowMs() + job.request.timeoutMs;
+
+    juce::WebInputStream in(job.request.url, true);
+    in.withExtraHeaders(job.request.headers).withConnectionTimeout(job.request.timeoutMs);
+
+    {
+        const juce::ScopedLock sl(lock);
+        runningStream = &in;
+    }
+
+    const bool connected = !job.cancelled->load() && in.connect(nullptr);
+    const int  httpStatus = connected ? in.getStatusCode() : 0;
+    const auto responseHeaders = connected ? in.getResponseHeaders() : juce::StringPairArray();
+
+    Status status = Status::ok;
+    bool   retry  = false;
+    if (job.cancelled->load() || threadShouldExit())
+        status = Status::cancelled;
+    else if (!connected || httpStatus == 429 || httpStatus >= 500)
+        retry = true;
+    else if (job.request.onResponse)
+    {
+        const StopCheck shouldStop = [this, &job, deadline]()
+        {
+            return job.cancelled->load() || threadShouldExit() || nowMs() > deadline;
+        };
+        job.request.onResponse(in, shouldStop);
+
+        if (job.cancelled->load() || threadShouldExit()) status = Status::cancelled;
+        else if (nowMs() > deadline)                     status = Status::timedOut;
+    }
+
+    {
+        const juce::ScopedLock sl(lock);
+        runningStream = nullptr;
+        runningOwner  = nullptr;
+        runningCancelled.reset();
+    }
+
+    if (retry) retryLater(std::move(job), httpStatus, responseHeaders);
+    else       finish(job, status, httpStatus);
+}
+
+void AiScheduler::retryLater(Job job, int httpStatus, const juce::StringPairArray& responseHeaders)
+{
+    if (++job.attempt >= MAX_ATTEMPTS)
+    {
+        finish(job, Status::failed, httpStatus);
+        return;
+    }
+
+    // Retry-After is in seconds; otherwise back off exponentially with jitter.
+    const auto retryAfter = responseHeaders.getValue("Retry-After", {}).trim();
+    const double delay = retryAfter.isNotEmpty() && retryAfter.containsOnly("0123456789")
+        ? retryAfter.getDoubleValue() * 1000.0
+        : (double)(BACKOFF_MS << (job.attempt - 1)) * (0.75 + 0.5 * random.nextDouble());
+    job.notBefore = nowMs() + juce::jmin((double)MAX_BACKOFF_MS, delay);
+
+    Status dropped = Status::cancelled;
+    {
+        const juce::ScopedLock sl(lock);
+        const bool superseded = std::any_of(queue.begin(), queue.end(),
+                                            [&](const Job& j) { return j.request.owner == job.request.owner; });
+        if (!job.cancelled->load() && !superseded)
+        {
+            if ((int)queue.size() < MAX_QUEUE)
+            {
+                queue.push_front(std::move(job));
+                return;
+            }
+            dropped = Status::failed;
+        }
+    }
+    finish(job, dropped, httpStatus);
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ─── AI scheduler ────────────────────────────────────────────────────────────
+// One worker thread shared by every plugin instance in the process (hold it
+// through a juce::SharedResourcePointer), so a session with many instances
+// never runs more than one HTTP request at a time.
+// - Each owner (an editor) has at most one live request. A new submit
+//   replaces the owner's queued request, which coalesces rapid button
+//   presses, or cancels its running one.
+// - Queued requests wait COALESCE_MS before they start, so a burst of
+//   presses costs one request.
+// - The queue is bounded. submit() refuses work when it is full.
+// - A token bucket spreads requests from all instances under the API's
+//   rate limit. Requests marked !rateLimited (local servers) bypass it.
+// - Each attempt has its own deadline. Connection failures, 429 and 5xx
+//   are retried with exponential backoff and jitter, and Retry-After is
+//   honoured.
+class AiScheduler : private juce::Thread
+{
+public:
+    static constexpr int    MAX_QUEUE      = 16;
+    static constexpr int    MAX_ATTEMPTS   = 4;
+    static constexpr int    COALESCE_MS    = 150;
+    static constexpr int    BACKOFF_MS     = 500;     // doubled per retry
+    static constexpr int    MAX_BACKOFF_MS = 8000;
+    static constexpr double RATE_PER_SECOND = 0.5;    // shared by all instances
+    static constexpr double RATE_BURST      = 4.0;
+
+    enum class Status { ok, failed, timedOut, cancelled };
+
+    using StopCheck = std::function<bool()>;
+
+    struct Request
+    {
+        const void*  owner = nullptr;
+        juce::URL    url;                  // with POST data
+        juce::String headers;
+        int          timeoutMs = 20000;    // per attempt, connect to last byte
+        bool         rateLimited = true;   // false for local servers
+
+        // Worker thread. Reads the response body (also for 4xx errors) and
+        // stops early once shouldStop() returns true.
+        std::function<void(juce::InputStream& in, const StopCheck& shouldStop)> onResponse;
+
+        // Worker thread, exactly once for every accepted request.
+        std::function<void(Status status, int httpStatus)> onFinished;
+    };
+
+    AiScheduler();
+    ~AiScheduler() override;
+
+    // Any thread. Returns false if the queue is full.
+    bool submit(Request request);
+
+    // Any thread. Drops the owner's queued request and stops its running one.
+    void cancel(const void* owner);
+
+private:
+    struct Job
+    {
+        Request request;
+        int     attempt = 0;
+        double  notBefore = 0.0;   // ms, Time::getMillisecondCounterHiRes
+        std::shared_ptr<std::atomic<bool>> cancelled = std::make_shared<std::atomic<bool>>(false);
+    };
+
+    void run() override;
+    int  takeNext(Job& job);   // wait time in ms if nothing is ready
+    void execute(Job job);
+    void retryLater(Job job, int httpStatus, const juce::StringPairArray& responseHeaders);
+
+    static void finish(Job& job, Status status, int httpStatus);
+
+    juce::CriticalSection lock;
+    std::deque<Job>       queue;
+    const void*           runningOwner = nullptr;
+    std::shared_ptr<std::atomic<bool>> runningCancelled;
+    juce::WebInputStream* runningStream = nullptr;
+
+    double       tokens = RATE_BURST, lastRefill = 0.0;
+    juce::Random random;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AiScheduler)
+};
@@ -0,0 +1,206 @@
+#include "AnalysisEngine.h"
+
+static float powerToDb(float power) noexcept
+{
+    return power > 1e-10f ? juce::jmax(AnalysisEngine::FLOOR_DB, 10.f * std::log10(power))
+                          : AnalysisEngine::FLOOR_DB;
+}
+
+AnalysisEngine::AnalysisEngine(AnalysisRing& source)
+    : juce::Thread("KeroAnalysis"), ring(source)
+{
+    auto s = std::make_shared<Snapshot>();
+    for (int b = 0; b < NUM_BANDS; ++b)
+    {
+        s->bandHz[b]  = 1000.f * std::exp2((float)(b - 17) / 3.f);
+        s->levelDb[b] = s->peakDb[b] = s->averageDb[b] = FLOOR_DB;
+    }
+    for (int r = 0; r < NUM_REGIONS; ++r)
+        s->regionLevelDb[r] = s->regionAverageDb[r] = FLOOR_DB;
+    latest = std::move(s);
+}
+
+AnalysisEngine::~AnalysisEngine()
+{
+    stopThread(1000);
+}
+
+void AnalysisEngine::setSampleRate(double sampleRate) noexcept { sr.store(sampleRate); }
+void AnalysisEngine::setOrder(int newOrder) noexcept           { order.store(juce::jlimit(MIN_ORDER, MAX_ORDER, newOrder)); }
+
+void AnalysisEngine::addClient()
+{
+    if (clients++ == 0) startThread(juce::Thread::Priority::low);
+}
+
+void AnalysisEngine::removeClient()
+{
+    jassert(clients > 0);
+    if (--clients == 0) stopThread(1000);
+}
+
+std::shared_ptr<const AnalysisEngine::Snapshot> AnalysisEngine::getSnapshot() const
+{
+    return std::atomic_load(&latest);
+}
+
+// ── Worker ────────────────────────────────────────────────────────────────────
+void AnalysisEngine::run()
+{
+    while (!threadShouldExit())
+        if (!analyseAvailableFrames())
+            wait(10);
+}
+
+bool AnalysisEngine::analyseAvailableFrames()
+{
+    const double rate = sr.load();
+    const int    ord  = order.load();
+    if (rate <= 0.0) return false;
+    if (rate != activeRate || ord != activeOrder) configure(rate, ord);
+
+    int done = 0;
+    for (;;)
+    {
+        const auto written = ring.getWriteCount();
+        if (written < nextFrame + (uint64_t)size) break;
+
+        // Fell more than a ring behind: skip to the newest full frame.
+        if (!ring.readAt(nextFrame, work.data(), size))
+        {
+            nextFrame = written - (uint64_t)size;
+            continue;
+        }
+
+        analyseFrame();
+        nextFrame += (uint64_t)hop;
+        ++done;
+    }
+
+    if (done > 0) publish();
+    return done > 0;
+}
+
+// Allocates; only ever called on the worker.
+void AnalysisEngine::configure(double rate, int fftOrder)
+{
+    activeRate  = rate;
+    activeOrder = fftOrder;
+    size        = 1 << fftOrder;
+    hop         = size / OVERLAP;
+
+    fft = std::make_unique<juce::dsp::FFT>(fftOrder);
+    work.assign((size_t)size * 2, 0.f);
+    window.resize((size_t)size);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t)size,
+        juce::dsp::WindowingFunction<float>::hann, false);
+
+    // One-sided power, scaled so a full-scale sine sums to 1 across its band.
+    double windowPower = 0.0;
+    for (float w : window) windowPower += (double)w * w;
+    powerScale = (float)(4.0 / ((double)size * windowPower));
+
+    frameSeconds = (float)(hop / rate);
+    fastCoef     = std::exp(-frameSeconds / FAST_SECONDS);
+    averageCoef  = std::exp(-frameSeconds / AVERAGE_SECONDS);
+
+    // Each bin counts towards a band by the fraction of its width inside the
+    // band, so adjacent bands never share power and the narrow low bands
+    // take part of a bin instead of a whole, rescaled one.
+    const double binHz   = rate / size;
+    const int    lastBin = size / 2;
+    for (int b = 0; b < NUM_BANDS; ++b)
+    {
+        bandHz[b] = 1000.f * std::exp2((float)(b - 17) / 3.f);
+        const double lo = bandHz[b] * std::exp2(-1.0 / 6.0), hi = bandHz[b] * std::exp2(1.0 / 6.0);
+
+        // Bin k spans [k, k + 1) here.
+        const double first = juce::jlimit(1.0, lastBin + 1.0, lo / binHz + 0.5);
+        const double last  = juce::jlimit(1.0, lastBin + 1.0, hi / binHz + 0.5);
+
+        binStart[b]       = (int)std::floor(first);
+        binEnd[b]         = juce::jmax(binStart[b], (int)std::ceil(last));
+        binStartWeight[b] = (float)(1.0 - (first - binStart[b]));
+        binEndWeight[b]   = (float)(1.0 - (binEnd[b] - last));
+    }
+
+    for (int b = 0; b < NUM_BANDS; ++b)
+    {
+        fastPower[b] = averagePower[b] = 0.f;
+        peakDb[b]    = FLOOR_DB;
+        peakHold[b]  = 0.f;
+    }
+
+    const auto written = ring.getWriteCount();
+    nextFrame = written > (uint64_t)size ? written - (uint64_t)size : 0;
+    frames    = 0;
+}
+
+void AnalysisEngine::analyseFrame()
+{
+    float* x = work.data();
+    juce::FloatVectorOperations::multiply(x, window.data(), size);
+    std::fill(x + size, x + size * 2, 0.f);
+    fft->performRealOnlyForwardTransform(x, true);
+
+    for (int b = 0; b < NUM_BANDS; ++b)
+    {
+        float sum = 0.f;
+        for (int k = binStart[b]; k < binEnd[b]; ++k)
+            sum += x[2 * k] * x[2 * k] + x[2 * k + 1] * x[2 * k + 1];
+        if (binEnd[b] > binStart[b])
+        {
+            const int k0 = binStart[b], k1 = binEnd[b] - 1;
+            sum -= (1.f - binStartWeight[b]) * (x[2 * k0] * x[2 * k0] + x[2 * k0 + 1] * x[2 * k0 + 1]);
+            sum -= (1.f - binEndWeight[b])   * (x[2 * k1] * x[2 * k1] + x[2 * k1 + 1] * x[2 * k1 + 1]);
+        }
+        const float power = juce::jmax(0.f, sum) * powerScale;
+
+        fastPower[b]    = power + fastCoef * (fastPower[b] - power);
+        averagePower[b] = power + averageCoef * (averagePower[b] - power);
+
+        const float db = powerToDb(power);
+        if (db >= peakDb[b])
+        {
+            peakDb[b]   = db;
+            peakHold[b] = PEAK_HOLD_SECONDS;
+        }
+        else if (peakHold[b] > 0.f)
+        {
+            peakHold[b] -= frameSeconds;
+        }
+        else
+        {
+            peakDb[b] = juce::jmax(db, peakDb[b] - PEAK_FALL_DB * frameSeconds);
+        }
+    }
+    ++frames;
+}
+
+void AnalysisEngine::publish()
+{
+    auto s = std::make_shared<Snapshot>();
+    s->sampleRate = activeRate;
+    s->fftOrder   = activeOrder;
+    s->frames     = frames;
+
+    float regionFast[NUM_REGIONS] = {}, regionAverage[NUM_REGIONS] = {};
+    for (int b = 0; b < NUM_BANDS; ++b)
+    {
+        s->bandHz[b]    = bandHz[b];
+        s->levelDb[b]   = powerToDb(fastPower[b]);
+        s->peakDb[b]    = peakDb[b];
+        s->averageDb[b] = powerToDb(averagePower[b]);
+
+        const int r = bandHz[b] < 300.f ? regionLow : (bandHz[b] < 4000.f ? regionMid : regionHigh);
+        regionFast[r]    += fastPower[b];
+        regionAverage[r] += averagePower[b];
+    }
+    for (int r = 0; r < NUM_REGIONS; ++r)
+    {
+        s->regionLevelDb[r]   = powerToDb(regionFast[r]);
+        s->regionAverageDb[r] = powerToDb(regionAverage[r]);
+    }
+
+    std::atomic_store(&latest, std::shared_ptr<const Snapshot>(std::move(s)));
+}
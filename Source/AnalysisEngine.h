@@ -0,0 +1,93 @@
+#pragma once
+#include <JuceHeader.h>
+#include "AnalysisRing.h"
+
+// ─── Analysis engine ─────────────────────────────────────────────────────────
+// Spectrum analysis on its own thread. Frames are read from the AnalysisRing
+// in order, with no gaps, through a Hann-windowed STFT with 75 % overlap. Each
+// frame is reduced to 1/3-octave band levels (20 Hz - 20 kHz) with fast
+// ballistics, peak hold and a long-term average. Results are published as an
+// immutable Snapshot swapped in atomically, so the GUI and the AI prompt read
+// them without touching an FFT. Levels are dBFS: a full-scale sine reads 0 dB
+// in its band once the band spans a few bins (above about 100 Hz at order 12,
+// 48 kHz). Lower bands are narrower than the window's main lobe, so a tone
+// there spreads into its neighbours and reads 4-6 dB low in its own band;
+// every bin is counted exactly once, so region levels still read 0 dB. The
+// thread only runs while at least one client is attached.
+class AnalysisEngine : private juce::Thread
+{
+public:
+    static constexpr int   MIN_ORDER     = 9;
+    static constexpr int   MAX_ORDER     = 13;
+    static constexpr int   DEFAULT_ORDER = 12;
+    static constexpr int   OVERLAP       = 4;     // hop = size / 4
+    static constexpr int   NUM_BANDS     = 31;    // 1/3 octave, 20 Hz .. 20 kHz
+    static constexpr float FLOOR_DB      = -100.f;
+
+    enum Region { regionLow, regionMid, regionHigh, NUM_REGIONS };   // < 300 Hz, < 4 kHz, above
+
+    struct Snapshot
+    {
+        double   sampleRate = 0.0;
+        int      fftOrder = 0;
+        uint64_t frames = 0;                        // STFT frames analysed so far
+
+        float bandHz[NUM_BANDS] = {};               // band centres
+        float levelDb[NUM_BANDS] = {};              // 125 ms ballistics
+        float peakDb[NUM_BANDS] = {};               // peak hold
+        float averageDb[NUM_BANDS] = {};            // long-term average
+
+        float regionLevelDb[NUM_REGIONS] = {};
+        float regionAverageDb[NUM_REGIONS] = {};
+    };
+
+    explicit AnalysisEngine(AnalysisRing& source);
+    ~AnalysisEngine() override;
+
+    // Any thread; picked up before the next frame.
+    void setSampleRate(double sampleRate) noexcept;
+    void setOrder(int order) noexcept;
+    int  getOrder() const noexcept { return order.load(); }
+
+    // Message thread. The worker runs while there is at least one client.
+    void addClient();
+    void removeClient();
+
+    // Any thread. Never null.
+    std::shared_ptr<const Snapshot> getSnapshot() const;
+
+private:
+    static constexpr float FAST_SECONDS      = 0.125f;
+    static constexpr float AVERAGE_SECONDS   = 5.f;
+    static constexpr float PEAK_HOLD_SECONDS = 1.5f;
+    static constexpr float PEAK_FALL_DB      = 20.f;   // per second, after the hold
+
+    void run() override;
+    bool analyseAvailableFrames();
+    void configure(double sampleRate, int fftOrder);
+    void analyseFrame();
+    void publish();
+
+    AnalysisRing&       ring;
+    std::atomic<double> sr{ 0.0 };
+    std::atomic<int>    order{ DEFAULT_ORDER };
+    int                 clients = 0;
+
+    std::shared_ptr<const Snapshot> latest;
+
+    // ── Worker state ───────────────────────────────────────────────────────
+    double   activeRate = 0.0;
+    int      activeOrder = 0, size = 0, hop = 0;
+    uint64_t nextFrame = 0, frames = 0;
+    float    powerScale = 0.f, fastCoef = 0.f, averageCoef = 0.f, frameSeconds = 0.f;
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float>              window, work;
+
+    int   binStart[NUM_BANDS] = {}, binEnd[NUM_BANDS] = {};
+    float binStartWeight[NUM_BANDS] = {}, binEndWeight[NUM_BANDS] = {}, bandHz[NUM_BANDS] = {};
+    float fastPower[NUM_BANDS] = {}, averagePower[NUM_BANDS] = {};
+    float peakDb[NUM_BANDS] = {}, peakHold[NUM_BANDS] = {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisEngine)
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ─── Analysis ring ───────────────────────────────────────────────────────────
+// Wait-free single-producer / single-consumer ring of mono analysis frames.
+// The audio thread pushes every block; readers copy out the newest N samples
+// whenever they like (overlapping reads are fine) without ever blocking the
+// writer. Tearing is detected seqlock-style: the writer announces how far it
+// is about to write before touching the buffer, and a read is only accepted
+// if none of the copied slots could have been reused meanwhile.
+class AnalysisRing
+{
+public:
+    explicit AnalysisRing(int capacityPow2)
+        : capacity(capacityPow2), mask((uint64_t)capacityPow2 - 1)
+    {
+        jassert(juce::isPowerOfTwo(capacityPow2));
+        buffer.calloc((size_t)capacity);
+    }
+
+    int getCapacity() const noexcept { return capacity; }
+
+    // Total number of frames pushed so far (monotonic).
+    uint64_t getWriteCount() const noexcept { return writeCount.load(std::memory_order_acquire); }
+
+    // Audio thread: pushes the average of the given channels.
+    void push(const float* const* channels, int numChannels, int numSamples) noexcept
+    {
+        if (numChannels <= 0 || numSamples <= 0) return;
+
+        const float scale = 1.f / (float)numChannels;
+        int done = 0;
+        while (done < numSamples)
+        {
+            const int n = juce::jmin(numSamples - done, capacity / 2);
+            const auto w = writeCount.load(std::memory_order_relaxed);
+
+            reserved.store(w + (uint64_t)n, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            const int pos   = (int)(w & mask);
+            const int first = juce::jmin(n, capacity - pos);
+            mixInto(buffer.get() + pos, channels, numChannels, done, first, scale);
+            mixInto(buffer.get(), channels, numChannels, done + first, n - first, scale);
+
+            writeCount.store(w + (uint64_t)n, std::memory_order_release);
+            done += n;
+        }
+    }
+
+    // Any reader thread: copies the newest numSamples frames, oldest first.
+    // Returns false if not enough data has been written yet or the writer
+    // lapped the reader during the copy. endCount receives the write count
+    // the copy ends at, so callers can implement a hop size.
+    bool readLatest(float* dest, int numSamples, uint64_t* endCount = nullptr) const noexcept
+    {
+        jassert(numSamples <= capacity);
+
+        for (int attempt = 0; attempt < 3; ++attempt)
+        {
+            const auto end = writeCount.load(std::memory_order_acquire);
+            if (end < (uint64_t)numSamples) return false;
+            const auto start = end - (uint64_t)numSamples;
+
+            const int pos   = (int)(start & mask);
+            const int first = juce::jmin(numSamples, capacity - pos);
+            std::memcpy(dest, buffer.get() + pos, sizeof(float) * (size_t)first);
+            std::memcpy(dest + first, buffer.get(), sizeof(float) * (size_t)(numSamples - first));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (reserved.load(std::memory_order_relaxed) - start <= (uint64_t)capacity)
+            {
+                if (endCount != nullptr) *endCount = end;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Any reader thread: copies numSamples frames starting at absolute frame
+    // startCount, for readers that must not skip any data. Returns false if
+    // the range is not fully written yet or has already been overwritten.
+    bool readAt(uint64_t startCount, float* dest, int numSamples) const noexcept
+    {
+        jassert(numSamples <= capacity);
+
+        const auto end = writeCount.load(std::memory_order_acquire);
+        if (startCount + (uint64_t)numSamples > end || end - startCount > (uint64_t)capacity)
+            return false;
+
+        const int pos   = (int)(startCount & mask);
+        const int first = juce::jmin(numSamples, capacity - pos);
+        std::memcpy(dest, buffer.get() + pos, sizeof(float) * (size_t)first);
+        std::memcpy(dest + first, buffer.get(), sizeof(float) * (size_t)(numSamples - first));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return reserved.load(std::memory_order_relaxed) - startCount <= (uint64_t)capacity;
+    }
+
+private:
+    static void mixInto(float* dst, const float* const* channels, int numChannels,
+                        int offset, int n, float scale) noexcept
+    {
+        if (n <= 0) return;
+        juce::FloatVectorOperations::copyWithMultiply(dst, channels[0] + offset, scale, n);
+        for (int ch = 1; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::addWithMultiply(dst, channels[ch] + offset, scale, n);
+    }
+
+    const int      capacity;
+    const uint64_t mask;
+    juce::HeapBlock<float> buffer;
+
+    std::atomic<uint64_t> writeCount{ 0 };
+    std::atomic<uint64_t> reserved{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(AnalysisRing)
+};
@@ -0,0 +1,140 @@
+#include "BusRouting.h"
+
+using CT = juce::AudioChannelSet::ChannelType;
+
+juce::AudioChannelSet BusRouting::getDefaultLayout(int numChannels)
+{
+    switch (numChannels)
+    {
+        case 10: return juce::AudioChannelSet::create7point1point2();
+        case 12: return juce::AudioChannelSet::create7point1point4();
+        case 16: return juce::AudioChannelSet::create9point1point6();
+        default: return juce::AudioChannelSet::canonicalChannelSet(numChannels);
+    }
+}
+
+// ── Roles ─────────────────────────────────────────────────────────────────────
+BusRouting::Side BusRouting::getSide(CT type) noexcept
+{
+    switch (type)
+    {
+        case CT::LFE: case CT::LFE2:
+            return sideNone;
+
+        case CT::left: case CT::leftCentre: case CT::wideLeft:
+        case CT::leftSurround: case CT::leftSurroundSide: case CT::leftSurroundRear:
+        case CT::topFrontLeft: case CT::topSideLeft: case CT::topRearLeft:
+        case CT::bottomFrontLeft: case CT::bottomSideLeft: case CT::bottomRearLeft:
+        case CT::proximityLeft:
+            return sideLeft;
+
+        case CT::right: case CT::rightCentre: case CT::wideRight:
+        case CT::rightSurround: case CT::rightSurroundSide: case CT::rightSurroundRear:
+        case CT::topFrontRight: case CT::topSideRight: case CT::topRearRight:
+        case CT::bottomFrontRight: case CT::bottomSideRight: case CT::bottomRearRight:
+        case CT::proximityRight:
+            return sideRight;
+
+        default:
+            return sideCentre;
+    }
+}
+
+BusRouting::Bed BusRouting::getBed(CT type) noexcept
+{
+    switch (type)
+    {
+        case CT::LFE: case CT::LFE2:
+            return bedLfe;
+
+        case CT::leftSurround: case CT::rightSurround: case CT::centreSurround:
+        case CT::leftSurroundSide: case CT::rightSurroundSide:
+        case CT::leftSurroundRear: case CT::rightSurroundRear:
+            return bedSurround;
+
+        case CT::topMiddle: case CT::topFrontLeft: case CT::topFrontCentre: case CT::topFrontRight:
+        case CT::topSideLeft: case CT::topSideRight:
+        case CT::topRearLeft: case CT::topRearCentre: case CT::topRearRight:
+        case CT::bottomFrontLeft: case CT::bottomFrontCentre: case CT::bottomFrontRight:
+        case CT::bottomSideLeft: case CT::bottomSideRight:
+        case CT::bottomRearLeft: case CT::bottomRearCentre: case CT::bottomRearRight:
+            return bedHeight;
+
+        default:
+            return bedFront;
+    }
+}
+
+// ── Setup ─────────────────────────────────────────────────────────────────────
+void BusRouting::prepare(const juce::AudioChannelSet& layout, int numChannels, int maxBlockSize)
+{
+    numCh  = juce::jlimit(1, MAX_CHANNELS, numChannels);
+    folded = numCh > 2;
+
+    Side sides[MAX_CHANNELS];
+    int  nextLfeGroup = bedLfe;
+    float weight[2] = {};
+
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        const auto type = ch < layout.size() ? layout.getTypeOfChannel(ch) : CT::unknown;
+        const auto bed  = getBed(type);
+
+        // Every LFE gets a group of its own.
+        const int lfeGroup = bed == bedLfe ? nextLfeGroup++ : -1;
+        linkGroups[linkByBed][ch] = bed == bedLfe ? lfeGroup : (int)bed;
+        linkGroups[linkAll][ch]   = bed == bedLfe ? lfeGroup : 0;
+
+        sides[ch] = getSide(type);
+        if (sides[ch] == sideLeft)   weight[0] += 1.f;
+        if (sides[ch] == sideRight)  weight[1] += 1.f;
+        if (sides[ch] == sideCentre) { weight[0] += 0.5f; weight[1] += 0.5f; }
+    }
+
+    // Each side of the send (and the return) keeps the power of one channel.
+    const float g[2] = { weight[0] > 0.f ? 1.f / std::sqrt(weight[0]) : 0.f,
+                         weight[1] > 0.f ? 1.f / std::sqrt(weight[1]) : 0.f };
+    const float centre = juce::MathConstants<float>::sqrt2 * 0.5f;
+
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        sendGains[ch][0] = sides[ch] == sideLeft ? g[0] : (sides[ch] == sideCentre ? g[0] * centre : 0.f);
+        sendGains[ch][1] = sides[ch] == sideRight ? g[1] : (sides[ch] == sideCentre ? g[1] * centre : 0.f);
+    }
+
+    send.setSize(2, folded ? juce::jmax(1, maxBlockSize) : 0);
+    sendDry.setSize(2, folded ? juce::jmax(1, maxBlockSize) : 0);
+}
+
+// ── Send / return ─────────────────────────────────────────────────────────────
+juce::dsp::AudioBlock<float> BusRouting::fillSend(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const int n   = juce::jmin((int)block.getNumSamples(), send.getNumSamples());
+    const int chs = juce::jmin((int)block.getNumChannels(), numCh);
+
+    send.clear(0, n);
+    for (int ch = 0; ch < chs; ++ch)
+        for (int s = 0; s < 2; ++s)
+            if (sendGains[ch][s] != 0.f)
+                send.addFrom(s, 0, block.getChannelPointer((size_t)ch), n, sendGains[ch][s]);
+
+    for (int s = 0; s < 2; ++s)
+        sendDry.copyFrom(s, 0, send, s, 0, n);
+
+    return juce::dsp::AudioBlock<float>(send).getSubBlock(0, (size_t)n);
+}
+
+void BusRouting::addReturn(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const int n   = juce::jmin((int)block.getNumSamples(), send.getNumSamples());
+    const int chs = juce::jmin((int)block.getNumChannels(), numCh);
+
+    for (int s = 0; s < 2; ++s)
+        juce::FloatVectorOperations::subtract(send.getWritePointer(s), sendDry.getReadPointer(s), n);
+
+    for (int ch = 0; ch < chs; ++ch)
+        for (int s = 0; s < 2; ++s)
+            if (sendGains[ch][s] != 0.f)
+                juce::FloatVectorOperations::addWithMultiply(block.getChannelPointer((size_t)ch),
+                                                             send.getReadPointer(s), sendGains[ch][s], n);
+}
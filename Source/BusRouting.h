@@ -0,0 +1,51 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ─── Bus routing ─────────────────────────────────────────────────────────────
+// Channel roles on multichannel buses, taken from the host layout.
+// Compressor link groups: the front, surround and height beds link
+// separately (or all together), and LFE channels never link.
+// Reverb send/return: both reverb engines are stereo. On buses wider than
+// stereo, the non-LFE channels are folded into a stereo send by side, with
+// centres split at -3 dB, and the wet return is spread back the same way.
+// Reverb cost stays flat with channel count and the LFE stays dry.
+class BusRouting
+{
+public:
+    static constexpr int MAX_CHANNELS = 16;   // up to 9.1.6
+
+    enum LinkScope { linkByBed, linkAll };
+
+    static juce::AudioChannelSet getDefaultLayout(int numChannels);
+
+    void prepare(const juce::AudioChannelSet& layout, int numChannels, int maxBlockSize);
+
+    // One group index per channel; channels sharing an index share a detector.
+    const int* getLinkGroups(LinkScope scope) const noexcept { return linkGroups[scope]; }
+
+    // Mono and stereo buses feed the reverb directly.
+    bool needsSend() const noexcept            { return folded; }
+    int  getNumReverbChannels() const noexcept { return folded ? 2 : numCh; }
+    int  getMaxSendSamples() const noexcept    { return send.getNumSamples(); }
+
+    // Audio thread, at most getMaxSendSamples() at a time: fold the block into
+    // the stereo send, let the reverb add its wet signal to the send in place,
+    // then spread the wet part back.
+    juce::dsp::AudioBlock<float> fillSend(const juce::dsp::AudioBlock<float>& block) noexcept;
+    void addReturn(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+private:
+    enum Side { sideLeft, sideRight, sideCentre, sideNone };
+    enum Bed  { bedFront, bedSurround, bedHeight, bedLfe };
+
+    static Side getSide(juce::AudioChannelSet::ChannelType type) noexcept;
+    static Bed  getBed(juce::AudioChannelSet::ChannelType type) noexcept;
+
+    int  numCh = 0;
+    bool folded = false;
+
+    int   linkGroups[2][MAX_CHANNELS] = {};
+    float sendGains[MAX_CHANNELS][2] = {};
+
+    juce::AudioBuffer<float> send, sendDry;
+};
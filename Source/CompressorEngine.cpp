@@ -0,0 +1,261 @@
+#include "CompressorEngine.h"
+
+static constexpr float kDbPerLog2  = 6.02059991f;     // 20 * log10(2)
+static constexpr float kLog2PerDb  = 1.f / kDbPerLog2;
+static constexpr float kDetFloor   = 1e-9f;
+static constexpr float kRestDb     = 1e-4f;     // envelope counts as released
+
+// ── Fast log2 / exp2 ──────────────────────────────────────────────────────────
+float CompressorEngine::fastLog2(float x) noexcept
+{
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    const float e = (float)((int)((bits >> 23) & 0xffu) - 127);
+    bits = (bits & 0x007fffffu) | 0x3f800000u;
+    float m;
+    std::memcpy(&m, &bits, sizeof(m));
+    const float t = m - 1.f;
+    return e + t * (1.4418255f + t * (-0.708678912f + t * (0.415411186f
+             + t * (-0.194408323f + t * 0.04587895f))));
+}
+
+float CompressorEngine::fastExp2(float x) noexcept
+{
+    x = juce::jlimit(-126.f, 126.f, x);
+    const float fi = std::floor(x);
+    const float f  = x - fi;
+    const float p  = 1.00000524f + f * (0.692974412f + f * (0.241508463f
+                   + f * (0.0519898759f + f * 0.0135115091f)));
+    uint32_t bits;
+    std::memcpy(&bits, &p, sizeof(bits));
+    bits += (uint32_t)(int32_t)fi << 23;
+    float r;
+    std::memcpy(&r, &bits, sizeof(r));
+    return r;
+}
+
+// ── Setup ─────────────────────────────────────────────────────────────────────
+void CompressorEngine::prepare(double sampleRate, int maxBlockSize, int /*numChannels*/)
+{
+    sr       = sampleRate;
+    maxBlock = juce::jmax(1, maxBlockSize);
+    scratch.allocate((size_t)maxBlock, true);
+    frames.assign((size_t)maxBlock, Vec::expand(0.f));
+    linked.setSize(MAX_CHANNELS, maxBlock);
+
+    cachedAttackMs = cachedReleaseMs = -1.f;
+    setParameters(params);
+    reset();
+}
+
+void CompressorEngine::reset()
+{
+    for (auto& g : gainDb) g = Vec::expand(0.f);
+    makeupDb = makeupTargetDb;
+}
+
+void CompressorEngine::setLinkGroups(const int* groupOfChannel, int numChannels) noexcept
+{
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+        linkGroup[ch] = ch < numChannels ? juce::jlimit(0, MAX_CHANNELS - 1, groupOfChannel[ch]) : ch;
+}
+
+void CompressorEngine::setSampleRate(double sampleRate)
+{
+    if (sampleRate == sr) return;
+    sr = sampleRate;
+    cachedAttackMs = cachedReleaseMs = -1.f;
+    setParameters(params);
+}
+
+void CompressorEngine::setParameters(const Parameters& newParams)
+{
+    params = newParams;
+
+    if (params.attackMs != cachedAttackMs)
+    {
+        attackCoef     = std::exp(-1.f / (float)(sr * params.attackMs * 0.001));
+        cachedAttackMs = params.attackMs;
+    }
+    if (params.releaseMs != cachedReleaseMs)
+    {
+        releaseCoef     = std::exp(-1.f / (float)(sr * params.releaseMs * 0.001));
+        cachedReleaseMs = params.releaseMs;
+    }
+
+    slope          = 1.f / juce::jmax(1.f, params.ratio) - 1.f;
+    makeupTargetDb = params.makeupDb;
+}
+
+// ── Gain chain ────────────────────────────────────────────────────────────────
+// |x| -> target gain (dB), in place. Branch-free so it vectorises.
+void CompressorEngine::computeTargetGain(float* data, int numSamples) const noexcept
+{
+    const float thresh     = params.thresholdDb;
+    const float halfKnee   = juce::jmax(0.f, params.kneeDb) * 0.5f;
+    const float invTwoKnee = halfKnee > 0.f ? 1.f / (4.f * halfKnee) : 0.f;
+    const float s          = slope;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float over = kDbPerLog2 * fastLog2(data[i] + kDetFloor) - thresh;
+        const float k    = over + halfKnee;
+        const float soft = s * k * k * invTwoKnee;
+        const float hard = s * over;
+        data[i] = over <= -halfKnee ? 0.f : (over >= halfKnee ? hard : soft);
+    }
+}
+
+// Attack/release picked per lane, so every channel keeps its own envelope.
+void CompressorEngine::smoothGain(Vec* data, int numSamples, Vec& state) const noexcept
+{
+    const Vec a   = Vec::expand(attackCoef), r = Vec::expand(releaseCoef);
+    const Vec one = Vec::expand(1.f);
+    Vec g = state;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const Vec target = data[i];
+        const Vec c = r + ((a - r) & Vec::lessThan(target, g));
+        g = c * g + (one - c) * target;
+        data[i] = g;
+    }
+    state = g;
+}
+
+// gain (dB) -> linear gain including makeup, in place; lanes values per sample.
+void CompressorEngine::gainToLinear(float* data, int numSamples, int lanes,
+                                    float makeupStart, float makeupStep) const noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+        for (int k = 0; k < lanes; ++k)
+            data[i * lanes + k] = fastExp2((data[i * lanes + k] + makeupStart + makeupStep * (float)i) * kLog2PerDb);
+}
+
+// ── Neutral fast path ─────────────────────────────────────────────────────────
+// With the envelope at rest and every sample below the knee (or ratio 1) the
+// gain computer outputs 0 dB throughout, so the chunk is just the makeup gain.
+bool CompressorEngine::isNeutral(const juce::dsp::AudioBlock<float>& block,
+                                 int start, int numSamples, int numCh) noexcept
+{
+    for (int ch = 0; ch < numCh; ++ch)
+        if (gainDb[ch / LANES].get((size_t)(ch % LANES)) < -kRestDb) return false;
+
+    if (slope != 0.f)
+    {
+        float peak = 0.f;
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            const auto r = juce::FloatVectorOperations::findMinAndMax(
+                block.getChannelPointer((size_t)ch) + start, numSamples);
+            peak = juce::jmax(peak, -r.getStart(), r.getEnd());
+        }
+
+        const float halfKnee = juce::jmax(0.f, params.kneeDb) * 0.5f;
+        const float over     = kDbPerLog2 * fastLog2(peak + kDetFloor) - params.thresholdDb;
+        if (over > -halfKnee) return false;
+    }
+
+    for (auto& g : gainDb) g = Vec::expand(0.f);
+    return true;
+}
+
+void CompressorEngine::applyMakeupOnly(const juce::dsp::AudioBlock<float>& block, int start,
+                                       int numSamples, int numCh, float makeupStart, float makeupStep) noexcept
+{
+    if (makeupStep == 0.f)
+    {
+        if (makeupStart == 0.f) return;
+        const float g = fastExp2(makeupStart * kLog2PerDb);
+        for (int ch = 0; ch < numCh; ++ch)
+            juce::FloatVectorOperations::multiply(block.getChannelPointer((size_t)ch) + start, g, numSamples);
+        return;
+    }
+
+    float* g = scratch.get();
+    juce::FloatVectorOperations::clear(g, numSamples);
+    gainToLinear(g, numSamples, 1, makeupStart, makeupStep);
+    for (int ch = 0; ch < numCh; ++ch)
+        juce::FloatVectorOperations::multiply(block.getChannelPointer((size_t)ch) + start, g, numSamples);
+}
+
+// Each link group's detector is the loudest of its members.
+void CompressorEngine::fillLinkedDetectors(const juce::dsp::AudioBlock<float>& block,
+                                           int start, int numSamples, int numCh) noexcept
+{
+    bool seen[MAX_CHANNELS] = {};
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        const auto* src = block.getChannelPointer((size_t)ch) + start;
+        float*      det = linked.getWritePointer(linkGroup[ch]);
+
+        if (!seen[linkGroup[ch]])
+        {
+            juce::FloatVectorOperations::abs(det, src, numSamples);
+            seen[linkGroup[ch]] = true;
+            continue;
+        }
+        for (int i = 0; i < numSamples; ++i)
+            det[i] = juce::jmax(det[i], std::abs(src[i]));
+    }
+}
+
+// ── Process ───────────────────────────────────────────────────────────────────
+void CompressorEngine::process(const juce::dsp::AudioBlock<float>& block)
+{
+    jassert(maxBlock > 0);
+    if (maxBlock <= 0) return;
+
+    const int numCh   = juce::jmin((int)block.getNumChannels(), MAX_CHANNELS);
+    const int numSamp = (int)block.getNumSamples();
+    auto*     raw     = reinterpret_cast<float*>(frames.data());
+
+    const float mkStep = numSamp > 0 ? (makeupTargetDb - makeupDb) / (float)numSamp : 0.f;
+
+    for (int start = 0; start < numSamp; start += maxBlock)
+    {
+        const int   n   = juce::jmin(maxBlock, numSamp - start);
+        const float mk0 = makeupDb + mkStep * (float)start;
+
+        if (isNeutral(block, start, n, numCh))
+        {
+            applyMakeupOnly(block, start, n, numCh, mk0, mkStep);
+            continue;
+        }
+
+        const bool link = params.link && numCh > 1;
+        if (link) fillLinkedDetectors(block, start, n, numCh);
+
+        for (int group = 0; group * LANES < numCh; ++group)
+        {
+            const int first = group * LANES;
+            const int lanes = juce::jmin(LANES, numCh - first);
+
+            for (int k = 0; k < LANES; ++k)
+            {
+                if (k >= lanes)
+                {
+                    for (int i = 0; i < n; ++i) raw[i * LANES + k] = 0.f;
+                    continue;
+                }
+
+                const auto* src = link ? linked.getReadPointer(linkGroup[first + k])
+                                       : block.getChannelPointer((size_t)(first + k)) + start;
+                for (int i = 0; i < n; ++i)
+                    raw[i * LANES + k] = std::abs(src[i]);
+            }
+
+            computeTargetGain(raw, n * LANES);
+            smoothGain(frames.data(), n, gainDb[group]);
+            gainToLinear(raw, n, LANES, mk0, mkStep);
+
+            for (int k = 0; k < lanes; ++k)
+            {
+                auto* data = block.getChannelPointer((size_t)(first + k)) + start;
+                for (int i = 0; i < n; ++i)
+                    data[i] *= raw[i * LANES + k];
+            }
+        }
+    }
+
+    makeupDb = makeupTargetDb;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ─── Block compressor ────────────────────────────────────────────────────────
+// Same topology as the original per-sample loop: instantaneous peak detector,
+// static gain curve in dB, attack/release smoothing of the gain in dB.
+// The log/exp work is done over whole blocks with branch-free polynomial
+// log2/exp2 so the compiler can vectorise it; only the envelope recursion
+// stays scalar.
+//
+// Error bound vs. Decibels::gainToDecibels / decibelsToGain:
+//   fastLog2  |err| < 3e-5      (detector error < 0.0002 dB)
+//   fastExp2  |rel| < 7e-6      (gain error     < 0.00007 dB)
+// so the applied gain is within 0.001 dB of the reference implementation.
+// Makeup changes are ramped linearly (in dB) across each process() call.
+// Chunks that cannot produce gain reduction skip the gain chain entirely.
+// Channels are processed in groups of SIMD lanes, so the envelope recursion
+// runs for 4 or 8 channels at once. With link on, every channel of a link
+// group follows the loudest member of that group.
+class CompressorEngine
+{
+public:
+    struct Parameters
+    {
+        float thresholdDb = -12.f;
+        float ratio       = 4.f;
+        float attackMs    = 10.f;
+        float releaseMs   = 100.f;
+        float makeupDb    = 0.f;
+        float kneeDb      = 0.f;
+        bool  link        = false;
+    };
+
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int LANES        = (int)Vec::SIMDNumElements;
+    static constexpr int MAX_CHANNELS = 16;
+
+    void prepare(double sampleRate, int maxBlockSize, int numChannels);
+    void reset();
+    void setSampleRate(double sampleRate);   // keeps the envelope, no allocation
+    void setParameters(const Parameters& newParams);
+    void setLinkGroups(const int* groupOfChannel, int numChannels) noexcept;   // default: one group
+
+    void process(const juce::dsp::AudioBlock<float>& block);
+
+    static float fastLog2(float x) noexcept;
+    static float fastExp2(float x) noexcept;
+
+private:
+    void computeTargetGain(float* data, int numSamples) const noexcept;
+    void smoothGain(Vec* data, int numSamples, Vec& state) const noexcept;
+    void gainToLinear(float* data, int numSamples, int lanes, float makeupStart, float makeupStep) const noexcept;
+
+    bool isNeutral(const juce::dsp::AudioBlock<float>& block, int start, int numSamples, int numCh) noexcept;
+    void applyMakeupOnly(const juce::dsp::AudioBlock<float>& block, int start, int numSamples,
+                         int numCh, float makeupStart, float makeupStep) noexcept;
+
+    void fillLinkedDetectors(const juce::dsp::AudioBlock<float>& block, int start, int numSamples, int numCh) noexcept;
+
+    static constexpr int MAX_GROUPS = (MAX_CHANNELS + LANES - 1) / LANES;
+
+    double sr = 44100.0;
+    int    maxBlock = 0;
+
+    Parameters params;
+    float attackCoef = 0.f, releaseCoef = 0.f, slope = 0.f;
+    float makeupDb = 0.f, makeupTargetDb = 0.f;
+    float cachedAttackMs = -1.f, cachedReleaseMs = -1.f;
+
+    Vec gainDb[MAX_GROUPS];
+    int linkGroup[MAX_CHANNELS] = {};
+
+    std::vector<Vec>         frames;    // [sample][lane], one SIMD group at a time
+    juce::AudioBuffer<float> linked;    // [link group][sample]
+    juce::HeapBlock<float>   scratch;
+};
@@ -0,0 +1,557 @@
+#include "ConvolutionReverb.h"
+
+static constexpr int kHeadFftSize  = 2 * ConvolutionReverb::HEAD_SIZE;
+static constexpr int kTailFftSize  = 2 * ConvolutionReverb::TAIL_SIZE;
+static constexpr int kHeadSpecSize = 2 * (ConvolutionReverb::HEAD_SIZE + 1);
+static constexpr int kTailSpecSize = 2 * (ConvolutionReverb::TAIL_SIZE + 1);
+
+// ── Worker ────────────────────────────────────────────────────────────────────
+// Rebuilds IR states when decay/damp/IR change, runs the tail partitions and
+// frees states the audio thread has swapped out. Sleeps on the thread's
+// WaitableEvent until one of those is signalled through wake().
+class ConvolutionReverb::Worker : public juce::Thread
+{
+public:
+    explicit Worker(ConvolutionReverb& o) : juce::Thread("KeroConvTail"), owner(o) {}
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            if (owner.rebuildRequested.exchange(false))
+            {
+                auto* s = owner.buildState(owner.sr, owner.decayTarget.load(), owner.dampTarget.load());
+                delete owner.pending.exchange(s, std::memory_order_acq_rel);
+            }
+
+            // Load before draining: every tail block that still references a
+            // retired state was submitted before it was retired.
+            const bool hasRetired = owner.retired.load(std::memory_order_acquire) != nullptr;
+
+            if (!owner.offline)
+                for (auto k = owner.completedBlocks.load();
+                     k < owner.submittedBlocks.load(std::memory_order_acquire); ++k)
+                    owner.processTailBlock(k);
+
+            if (hasRetired) owner.collectRetired();
+
+            wait(-1);
+        }
+    }
+
+private:
+    ConvolutionReverb& owner;
+};
+
+// ── Lifetime ──────────────────────────────────────────────────────────────────
+ConvolutionReverb::ConvolutionReverb()
+    : worker(std::make_unique<Worker>(*this))
+{
+}
+
+ConvolutionReverb::~ConvolutionReverb()
+{
+    worker->stopThread(2000);
+    delete active;
+    delete pending.exchange(nullptr);
+    delete retired.exchange(nullptr);
+}
+
+// ── IR source ─────────────────────────────────────────────────────────────────
+bool ConvolutionReverb::loadImpulseResponse(const juce::File& file)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+    if (reader == nullptr || reader->sampleRate <= 0.0) return false;
+
+    const int len = (int)juce::jmin(reader->lengthInSamples,
+                                    (juce::int64)(reader->sampleRate * MAX_IR_SECONDS));
+    if (len <= 0) return false;
+
+    juce::AudioBuffer<float> ir(juce::jlimit(1, MAX_CHANNELS, (int)reader->numChannels), len);
+    reader->read(&ir, 0, len, 0, true, true);
+
+    {
+        juce::ScopedLock sl(irLock);
+        sourceIr   = std::move(ir);
+        sourceRate = reader->sampleRate;
+        sourceFile = file;
+    }
+
+    rebuildRequested = true;
+    if (!worker->isThreadRunning()) worker->startThread(juce::Thread::Priority::high);
+    wake();
+    return true;
+}
+
+void ConvolutionReverb::clearImpulseResponse()
+{
+    {
+        juce::ScopedLock sl(irLock);
+        sourceIr.setSize(0, 0);
+        sourceRate = 0.0;
+        sourceFile = juce::File();
+    }
+    rebuildRequested = true;
+    wake();
+}
+
+juce::File ConvolutionReverb::getImpulseResponseFile() const
+{
+    juce::ScopedLock sl(irLock);
+    return sourceFile;
+}
+
+// ── Build ─────────────────────────────────────────────────────────────────────
+ConvolutionReverb::IrState* ConvolutionReverb::buildState(double sampleRate, float decay, float damp) const
+{
+    juce::AudioBuffer<float> src;
+    double srcRate;
+    {
+        juce::ScopedLock sl(irLock);
+        src.makeCopyOf(sourceIr);
+        srcRate = sourceRate;
+    }
+
+    auto* s = new IrState();
+    if (src.getNumSamples() == 0 || srcRate <= 0.0 || sampleRate <= 0.0) return s;
+
+    // Resample to the session rate.
+    const double ratio  = srcRate / sampleRate;
+    const int    outLen = juce::jmin((int)(src.getNumSamples() / ratio),
+                                     (int)(MAX_IR_SECONDS * sampleRate));
+    if (outLen <= 0) return s;
+
+    juce::AudioBuffer<float> ir(src.getNumChannels(), outLen);
+    for (int ch = 0; ch < src.getNumChannels(); ++ch)
+    {
+        if (ratio == 1.0)
+        {
+            ir.copyFrom(ch, 0, src, ch, 0, outLen);
+            continue;
+        }
+        std::vector<float> padded((size_t)src.getNumSamples() + 512, 0.f);
+        std::copy(src.getReadPointer(ch), src.getReadPointer(ch) + src.getNumSamples(), padded.begin());
+        juce::WindowedSincInterpolator interp;
+        interp.process(ratio, padded.data(), ir.getWritePointer(ch), outLen);
+    }
+
+    // Unit-energy normalisation, then the decay envelope.
+    double energy = 0.0;
+    for (int ch = 0; ch < ir.getNumChannels(); ++ch)
+        for (int i = 0; i < outLen; ++i)
+            energy += (double)ir.getSample(ch, i) * ir.getSample(ch, i);
+    energy /= ir.getNumChannels();
+    const float norm = energy > 0.0 ? (float)(1.0 / std::sqrt(energy)) : 0.f;
+
+    const double tau  = 0.05 * std::pow(200.0, (double)juce::jlimit(0.f, 1.f, decay));
+    const float  step = (float)std::exp(-1.0 / (tau * sampleRate));
+    for (int ch = 0; ch < ir.getNumChannels(); ++ch)
+    {
+        auto* d = ir.getWritePointer(ch);
+        float env = norm;
+        for (int i = 0; i < outLen; ++i) { d[i] *= env; env *= step; }
+    }
+
+    // Damp: a one-pole low-pass run along the IR that closes with time,
+    // -60 dB at Nyquist after 0.5 s at damp = 1. Shaping the IR itself keeps
+    // every partition causal, so nothing wraps around the FFT blocks.
+    const float dampStep = std::exp(-juce::jlimit(0.f, 1.f, damp) * 13.8f / (float)sampleRate);
+    for (int ch = 0; ch < ir.getNumChannels(); ++ch)
+    {
+        auto* d = ir.getWritePointer(ch);
+        float nyquistGain = 1.f, y = 0.f;
+        for (int i = 0; i < outLen; ++i)
+        {
+            const float c = (1.f - nyquistGain) / (1.f + nyquistGain);
+            y = d[i] + c * (y - d[i]);
+            d[i] = y;
+            nyquistGain *= dampStep;
+        }
+    }
+
+    s->numChannels = ir.getNumChannels();
+    s->length      = outLen;
+
+    auto transformPartition = [](const juce::dsp::FFT& fft, int fftSize, const float* data, int count, float* dest)
+        {
+            std::vector<float> work((size_t)fftSize * 2, 0.f);
+            std::copy(data, data + count, work.begin());
+            fft.performRealOnlyForwardTransform(work.data(), true);
+            std::copy(work.begin(), work.begin() + fftSize + 2, dest);
+        };
+
+    juce::dsp::FFT headFftLocal(HEAD_FFT_ORDER), tailFftLocal(TAIL_FFT_ORDER);
+
+    s->headTaps.setSize(s->numChannels, HEAD_SIZE);
+    s->headTaps.clear();
+    s->headParts = juce::jlimit(0, HEAD_PARTS, (outLen - HEAD_SIZE + HEAD_SIZE - 1) / HEAD_SIZE);
+    const int tailStart = 2 * TAIL_SIZE;
+    s->tailParts = outLen > tailStart ? (outLen - tailStart + TAIL_SIZE - 1) / TAIL_SIZE : 0;
+
+    for (int ch = 0; ch < s->numChannels; ++ch)
+    {
+        const float* d = ir.getReadPointer(ch);
+        s->headTaps.copyFrom(ch, 0, d, juce::jmin(HEAD_SIZE, outLen));
+
+        s->headSpectra[ch].assign((size_t)(HEAD_PARTS * kHeadSpecSize), 0.f);
+        for (int j = 0; j < s->headParts; ++j)
+        {
+            const int start = HEAD_SIZE + j * HEAD_SIZE;
+            transformPartition(headFftLocal, kHeadFftSize, d + start, juce::jmin(HEAD_SIZE, outLen - start),
+                               s->headSpectra[ch].data() + j * kHeadSpecSize);
+        }
+
+        s->tailSpectra[ch].assign((size_t)s->tailParts * kTailSpecSize, 0.f);
+        for (int j = 0; j < s->tailParts; ++j)
+        {
+            const int start = tailStart + j * TAIL_SIZE;
+            transformPartition(tailFftLocal, kTailFftSize, d + start, juce::jmin(TAIL_SIZE, outLen - start),
+                               s->tailSpectra[ch].data() + (size_t)j * kTailSpecSize);
+        }
+    }
+    return s;
+}
+
+// ── Setup ─────────────────────────────────────────────────────────────────────
+void ConvolutionReverb::prepare(double sampleRate, int /*maxBlockSize*/, int numChannels, bool nonRealtime)
+{
+    worker->stopThread(2000);
+
+    sr      = sampleRate;
+    numCh   = juce::jlimit(1, MAX_CHANNELS, numChannels);
+    offline = nonRealtime;
+
+    headHistory.setSize(numCh, 2 * HEAD_SIZE - 1);
+    headPrev.setSize(numCh, HEAD_SIZE);
+    headOut.setSize(numCh, HEAD_SIZE);
+    headWork.assign((size_t)kHeadFftSize * 4, 0.f);
+    wet.assign((size_t)HEAD_SIZE, 0.f);
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+        headFdl[ch].assign((size_t)(HEAD_PARTS * kHeadSpecSize), 0.f);
+
+    for (int s = 0; s < TAIL_SLOTS; ++s)
+    {
+        tailIn[s].setSize(numCh, TAIL_SIZE);
+        tailOut[s].setSize(numCh, TAIL_SIZE);
+        tailSlotState[s] = nullptr;
+    }
+    tailPrev.setSize(numCh, TAIL_SIZE);
+    tailWork.assign((size_t)kTailFftSize * 2, 0.f);
+    tailAcc.assign((size_t)kTailFftSize * 2, 0.f);
+    tailFdlParts = 0;
+
+    delete active;
+    delete pending.exchange(nullptr);
+    delete retired.exchange(nullptr);
+
+    lastDecay = decayTarget.load();
+    lastDamp  = dampTarget.load();
+    active    = buildState(sr, lastDecay, lastDamp);
+    rebuildRequested = false;
+    publishActive();
+
+    reset();
+
+    if (active->length > 0)
+        worker->startThread(juce::Thread::Priority::high);
+}
+
+void ConvolutionReverb::reset()
+{
+    headHistory.clear();
+    headPrev.clear();
+    headOut.clear();
+    for (auto& f : headFdl) std::fill(f.begin(), f.end(), 0.f);
+    headPos = headFdlPos = 0;
+
+    for (int s = 0; s < TAIL_SLOTS; ++s) { tailIn[s].clear(); tailOut[s].clear(); }
+    tailPrev.clear();
+    for (auto& f : tailFdl) std::fill(f.begin(), f.end(), 0.f);
+    tailFdlPos = tailPos = 0;
+    tailBlock  = 0;
+    submittedBlocks = 0;
+    completedBlocks = 0;
+    lateTailBlocks  = 0;
+    tailOverruns    = 0;
+    tailSkipTo      = 0;
+    tailClearFrom   = -1;
+    tailMutedUntil  = 0;
+}
+
+void ConvolutionReverb::setParameters(float decay, float damp) noexcept
+{
+    if (std::abs(decay - lastDecay) < 1e-3f && std::abs(damp - lastDamp) < 1e-3f) return;
+    lastDecay = decay;
+    lastDamp  = damp;
+    decayTarget.store(decay);
+    dampTarget.store(damp);
+    rebuildRequested.store(true);
+    wake();
+}
+
+// Head state belongs to the audio thread and is cleared here; the worker is
+// told to drop the tail history from the current block on, and the two tail
+// results still in flight are muted.
+void ConvolutionReverb::clearHistory() noexcept
+{
+    headHistory.clear();
+    headPrev.clear();
+    headOut.clear();
+    for (auto& f : headFdl) std::fill(f.begin(), f.end(), 0.f);
+
+    auto& in = tailIn[tailBlock % TAIL_SLOTS];
+    for (int ch = 0; ch < in.getNumChannels(); ++ch)
+        juce::FloatVectorOperations::clear(in.getWritePointer(ch), tailPos);
+
+    tailClearFrom.store(tailBlock, std::memory_order_release);
+    tailMutedUntil = tailBlock + 2;
+}
+
+// ── State handoff ─────────────────────────────────────────────────────────────
+void ConvolutionReverb::adoptPendingState() noexcept
+{
+    if (retired.load(std::memory_order_acquire) != nullptr) return;
+
+    if (auto* s = pending.exchange(nullptr, std::memory_order_acq_rel))
+    {
+        auto* old = active;
+        active = s;
+        if (old != nullptr)
+        {
+            retired.store(old, std::memory_order_release);
+            wake();
+        }
+        publishActive();
+    }
+}
+
+void ConvolutionReverb::publishActive() noexcept
+{
+    const bool has = active != nullptr && active->numChannels > 0;
+    activeSeconds.store(has ? (float)(active->length / sr) : 0.f, std::memory_order_release);
+    activeChannels.store(has ? active->numChannels : 0, std::memory_order_release);
+}
+
+void ConvolutionReverb::wake() noexcept
+{
+    worker->notify();
+}
+
+void ConvolutionReverb::collectRetired()
+{
+    delete retired.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+// ── Spectral helpers ──────────────────────────────────────────────────────────
+void ConvolutionReverb::complexMultiplyAccumulate(float* acc, const float* x, const float* h, int bins) noexcept
+{
+    for (int b = 0; b < bins; ++b)
+    {
+        const float xr = x[2 * b], xi = x[2 * b + 1];
+        const float hr = h[2 * b], hi = h[2 * b + 1];
+        acc[2 * b]     += xr * hr - xi * hi;
+        acc[2 * b + 1] += xr * hi + xi * hr;
+    }
+}
+
+void ConvolutionReverb::fillConjugateHalf(float* data, int fftSize) noexcept
+{
+    for (int b = fftSize / 2 + 1; b < fftSize; ++b)
+    {
+        data[2 * b]     =  data[2 * (fftSize - b)];
+        data[2 * b + 1] = -data[2 * (fftSize - b) + 1];
+    }
+}
+
+// ── Head stage ────────────────────────────────────────────────────────────────
+void ConvolutionReverb::headFrameBoundary() noexcept
+{
+    const IrState& ir = *active;
+    float* work = headWork.data();
+    float* acc  = work + kHeadFftSize * 2;
+
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        const int irCh  = juce::jmin(ch, ir.numChannels - 1);
+        float*    hist  = headHistory.getWritePointer(ch);
+        float*    prev  = headPrev.getWritePointer(ch);
+        const float* cur = hist + HEAD_SIZE - 1;
+
+        std::fill(work, work + kHeadFftSize * 2, 0.f);
+        std::copy(prev, prev + HEAD_SIZE, work);
+        std::copy(cur, cur + HEAD_SIZE, work + HEAD_SIZE);
+        std::copy(cur, cur + HEAD_SIZE, prev);
+        headFft.performRealOnlyForwardTransform(work, true);
+
+        float* fdl = headFdl[ch].data();
+        std::copy(work, work + kHeadSpecSize, fdl + headFdlPos * kHeadSpecSize);
+
+        std::fill(acc, acc + kHeadFftSize * 2, 0.f);
+        const float* h = ir.headSpectra[irCh].data();
+        for (int j = 0; j < ir.headParts; ++j)
+        {
+            const int slot = (headFdlPos - j + HEAD_PARTS) % HEAD_PARTS;
+            complexMultiplyAccumulate(acc, fdl + slot * kHeadSpecSize, h + j * kHeadSpecSize, HEAD_SIZE + 1);
+        }
+        fillConjugateHalf(acc, kHeadFftSize);
+        headFft.performRealOnlyInverseTransform(acc);
+        std::copy(acc + HEAD_SIZE, acc + 2 * HEAD_SIZE, headOut.getWritePointer(ch));
+
+        std::copy(hist + HEAD_SIZE, hist + 2 * HEAD_SIZE - 1, hist);
+    }
+
+    headFdlPos = (headFdlPos + 1) % HEAD_PARTS;
+    headPos = 0;
+}
+
+// ── Tail stage ────────────────────────────────────────────────────────────────
+// The next block reuses the slot of block tailBlock + 1 - TAIL_SLOTS. If the
+// worker has not finished that one it is too far behind to catch up: it
+// skips everything before the next block and restarts its history there,
+// and the tail stays muted until results from that block arrive.
+void ConvolutionReverb::tailBlockBoundary() noexcept
+{
+    tailSlotState[tailBlock % TAIL_SLOTS] = active;
+    submittedBlocks.store(tailBlock + 1, std::memory_order_release);
+
+    if (offline) processTailBlock(tailBlock);
+    else         wake();
+
+    ++tailBlock;
+    tailPos = 0;
+
+    if (!offline && completedBlocks.load(std::memory_order_acquire) < tailBlock + 1 - TAIL_SLOTS)
+    {
+        tailSkipTo.store(tailBlock, std::memory_order_release);
+        tailClearFrom.store(tailBlock, std::memory_order_release);
+        tailMutedUntil = tailBlock + 2;
+        ++tailOverruns;
+    }
+}
+
+void ConvolutionReverb::processTailBlock(int64_t blockIndex)
+{
+    if (blockIndex < tailSkipTo.load(std::memory_order_acquire))
+    {
+        completedBlocks.store(blockIndex + 1, std::memory_order_release);
+        return;
+    }
+
+    const int slot = (int)(blockIndex % TAIL_SLOTS);
+    const IrState& ir = *tailSlotState[slot];
+
+    auto clearFrom = tailClearFrom.load(std::memory_order_acquire);
+    if (clearFrom >= 0 && blockIndex >= clearFrom)
+    {
+        tailPrev.clear();
+        for (auto& f : tailFdl) std::fill(f.begin(), f.end(), 0.f);
+        tailClearFrom.compare_exchange_strong(clearFrom, -1);
+    }
+
+    if (ir.tailParts != tailFdlParts)
+    {
+        for (auto& f : tailFdl) f.assign((size_t)ir.tailParts * kTailSpecSize, 0.f);
+        tailFdlParts = ir.tailParts;
+        tailFdlPos   = 0;
+    }
+
+    float* work = tailWork.data();
+    float* acc  = tailAcc.data();
+
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        const float* in   = tailIn[slot].getReadPointer(ch);
+        float*       prev = tailPrev.getWritePointer(ch);
+        float*       out  = tailOut[slot].getWritePointer(ch);
+
+        if (tailFdlParts == 0 || ir.numChannels == 0)
+        {
+            std::copy(in, in + TAIL_SIZE, prev);
+            std::fill(out, out + TAIL_SIZE, 0.f);
+            continue;
+        }
+
+        const int irCh = juce::jmin(ch, ir.numChannels - 1);
+
+        std::fill(work, work + kTailFftSize * 2, 0.f);
+        std::copy(prev, prev + TAIL_SIZE, work);
+        std::copy(in, in + TAIL_SIZE, work + TAIL_SIZE);
+        std::copy(in, in + TAIL_SIZE, prev);
+        tailFft.performRealOnlyForwardTransform(work, true);
+
+        float* fdl = tailFdl[ch].data();
+        std::copy(work, work + kTailSpecSize, fdl + (size_t)tailFdlPos * kTailSpecSize);
+
+        std::fill(acc, acc + kTailFftSize * 2, 0.f);
+        const float* h = ir.tailSpectra[irCh].data();
+        for (int j = 0; j < tailFdlParts; ++j)
+        {
+            const int p = (tailFdlPos - j + tailFdlParts) % tailFdlParts;
+            complexMultiplyAccumulate(acc, fdl + (size_t)p * kTailSpecSize,
+                                      h + (size_t)j * kTailSpecSize, TAIL_SIZE + 1);
+        }
+        fillConjugateHalf(acc, kTailFftSize);
+        tailFft.performRealOnlyInverseTransform(acc);
+        std::copy(acc + TAIL_SIZE, acc + 2 * TAIL_SIZE, out);
+    }
+
+    if (tailFdlParts > 0) tailFdlPos = (tailFdlPos + 1) % tailFdlParts;
+    completedBlocks.store(blockIndex + 1, std::memory_order_release);
+}
+
+// ── Process ───────────────────────────────────────────────────────────────────
+void ConvolutionReverb::process(const juce::dsp::AudioBlock<float>& block,
+                                float mixStart, float mixEnd) noexcept
+{
+    if (active == nullptr || active->numChannels == 0) return;
+
+    const IrState& ir = *active;
+    const int chs     = juce::jmin(numCh, (int)block.getNumChannels());
+    const int numSamp = (int)block.getNumSamples();
+    if (numSamp <= 0) return;
+
+    const float mixStep = (mixEnd - mixStart) / (float)numSamp;
+
+    for (int i = 0; i < numSamp;)
+    {
+        const int m = juce::jmin(numSamp - i, HEAD_SIZE - headPos);
+
+        const int  outSlot   = (int)((tailBlock + TAIL_SLOTS - 2) % TAIL_SLOTS);
+        const bool tailReady = tailBlock >= 2 && tailBlock >= tailMutedUntil
+                            && completedBlocks.load(std::memory_order_acquire) >= tailBlock - 1;
+        if (tailBlock >= 2 && tailBlock >= tailMutedUntil && !tailReady && tailPos == 0) ++lateTailBlocks;
+
+        for (int ch = 0; ch < chs; ++ch)
+        {
+            float*    data = block.getChannelPointer((size_t)ch) + i;
+            float*    hist = headHistory.getWritePointer(ch);
+            const int irCh = juce::jmin(ch, ir.numChannels - 1);
+
+            juce::FloatVectorOperations::copy(hist + HEAD_SIZE - 1 + headPos, data, m);
+            juce::FloatVectorOperations::copy(tailIn[tailBlock % TAIL_SLOTS].getWritePointer(ch) + tailPos, data, m);
+
+            float* w = wet.data();
+            juce::FloatVectorOperations::copy(w, headOut.getReadPointer(ch) + headPos, m);
+            if (tailReady)
+                juce::FloatVectorOperations::add(w, tailOut[outSlot].getReadPointer(ch) + tailPos, m);
+
+            const float* taps = ir.headTaps.getReadPointer(irCh);
+            const float* x    = hist + HEAD_SIZE - 1 + headPos;
+            for (int k = 0; k < HEAD_SIZE; ++k)
+                juce::FloatVectorOperations::addWithMultiply(w, x - k, taps[k], m);
+
+            const float mix0 = mixStart + mixStep * (float)i;
+            for (int t = 0; t < m; ++t)
+                data[t] += w[t] * (mix0 + mixStep * (float)t);
+        }
+
+        i       += m;
+        headPos += m;
+        tailPos += m;
+        if (headPos == HEAD_SIZE) headFrameBoundary();
+        if (tailPos == TAIL_SIZE) tailBlockBoundary();
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ─── Convolution reverb ──────────────────────────────────────────────────────
+// Zero-latency non-uniform partitioned convolution:
+//   [0, P)        direct-form FIR on the audio thread
+//   [P, 2Q)       uniformly partitioned FFT convolution, partitions of P,
+//                 on the audio thread
+//   [2Q, end)     uniformly partitioned FFT convolution, partitions of Q,
+//                 on a background worker with one full Q-block of deadline
+// Audio-thread cost is fixed by P and Q, so it does not grow with IR length.
+// The IR is resampled to the session rate in prepare(); decay shapes it with
+// an exponential envelope and damp runs it through a low-pass that closes
+// with time. Both trigger a rebuild on the worker, swapped in lock-free.
+class ConvolutionReverb
+{
+public:
+    static constexpr int   HEAD_SIZE      = 128;      // P
+    static constexpr int   TAIL_SIZE      = 4096;     // Q
+    static constexpr float MAX_IR_SECONDS = 10.f;
+
+    ConvolutionReverb();
+    ~ConvolutionReverb();
+
+    // Message thread
+    bool       loadImpulseResponse(const juce::File& file);
+    void       clearImpulseResponse();
+    juce::File getImpulseResponseFile() const;
+
+    // Not concurrent with process()
+    void prepare(double sampleRate, int maxBlockSize, int numChannels, bool nonRealtime);
+
+    // Any thread; follow the state the audio thread last adopted.
+    bool  isActive() const noexcept       { return activeChannels.load(std::memory_order_acquire) > 0; }
+    float getTailSeconds() const noexcept { return activeSeconds.load(std::memory_order_acquire); }
+
+    // Audio thread. adoptPendingState() swaps in a finished rebuild; call it
+    // at the start of every block, whether or not process() runs.
+    void  adoptPendingState() noexcept;
+    void  setParameters(float decay, float damp) noexcept;
+    void  process(const juce::dsp::AudioBlock<float>& block, float mixStart, float mixEnd) noexcept;
+    void  clearHistory() noexcept;   // forget past input, e.g. after process() was skipped
+    int   getLateTailBlocks() const noexcept { return lateTailBlocks.load(); }
+    int   getTailOverruns() const noexcept   { return tailOverruns.load(); }
+
+private:
+    static constexpr int HEAD_FFT_ORDER = 8;    // 2P
+    static constexpr int TAIL_FFT_ORDER = 13;   // 2Q
+    static constexpr int HEAD_PARTS     = (2 * TAIL_SIZE - HEAD_SIZE) / HEAD_SIZE;
+    static constexpr int TAIL_SLOTS     = 4;
+    static constexpr int MAX_CHANNELS   = 2;
+
+    struct IrState
+    {
+        int numChannels = 0, length = 0;
+        int headParts = 0, tailParts = 0;
+        juce::AudioBuffer<float> headTaps;                    // [ch][P]
+        std::vector<float>       headSpectra[MAX_CHANNELS];   // HEAD_PARTS x 2(P+1)
+        std::vector<float>       tailSpectra[MAX_CHANNELS];   // tailParts x 2(Q+1)
+    };
+
+    class Worker;
+    friend class Worker;
+
+    IrState* buildState(double sampleRate, float decay, float damp) const;
+    void     reset();
+    void     publishActive() noexcept;
+    void     headFrameBoundary() noexcept;
+    void     tailBlockBoundary() noexcept;
+    void     processTailBlock(int64_t blockIndex);
+    void     collectRetired();
+    void     wake() noexcept;
+
+    static void complexMultiplyAccumulate(float* acc, const float* x, const float* h, int bins) noexcept;
+    static void fillConjugateHalf(float* data, int fftSize) noexcept;
+
+    // ── IR source (message thread / worker, under irLock) ──────────────────
+    mutable juce::CriticalSection irLock;
+    juce::AudioBuffer<float> sourceIr;
+    double                   sourceRate = 0.0;
+    juce::File               sourceFile;
+
+    // ── Settings ───────────────────────────────────────────────────────────
+    double sr = 44100.0;
+    int    numCh = 2;
+    bool   offline = false;
+    std::atomic<float> decayTarget{ 0.5f }, dampTarget{ 0.3f };
+    float  lastDecay = -1.f, lastDamp = -1.f;
+    std::atomic<bool>  rebuildRequested{ false };
+
+    // ── State handoff ──────────────────────────────────────────────────────
+    IrState*              active = nullptr;              // audio thread
+    std::atomic<IrState*> pending{ nullptr };            // worker -> audio
+    std::atomic<IrState*> retired{ nullptr };            // audio -> worker
+    std::atomic<int>      activeChannels{ 0 };           // copies of `active` for other threads
+    std::atomic<float>    activeSeconds{ 0.f };
+
+    // ── Head stage (audio thread) ──────────────────────────────────────────
+    juce::dsp::FFT headFft{ HEAD_FFT_ORDER };
+    juce::AudioBuffer<float> headHistory;                // [ch][P - 1 + P]
+    juce::AudioBuffer<float> headPrev, headOut;          // [ch][P]
+    std::vector<float> headFdl[MAX_CHANNELS];            // HEAD_PARTS x 2(P+1)
+    std::vector<float> headWork;                         // 2 * 2P
+    std::vector<float> wet;
+    int headPos = 0, headFdlPos = 0;
+
+    // ── Tail stage (worker, or audio thread when offline) ──────────────────
+    juce::dsp::FFT tailFft{ TAIL_FFT_ORDER };
+    juce::AudioBuffer<float> tailIn[TAIL_SLOTS], tailOut[TAIL_SLOTS];   // [ch][Q]
+    IrState*                 tailSlotState[TAIL_SLOTS] = {};
+    juce::AudioBuffer<float> tailPrev;
+    std::vector<float>       tailFdl[MAX_CHANNELS];
+    std::vector<float>       tailWork, tailAcc;
+    int     tailFdlParts = 0, tailFdlPos = 0;
+    int     tailPos = 0;
+    int64_t tailBlock = 0;
+    std::atomic<int64_t> submittedBlocks{ 0 }, completedBlocks{ 0 };
+    std::atomic<int64_t> tailClearFrom{ -1 };      // worker drops its history at this block
+    int64_t              tailMutedUntil = 0;       // results before this block are stale
+    std::atomic<int64_t> tailSkipTo{ 0 };          // worker skips blocks before this one
+    std::atomic<int>     lateTailBlocks{ 0 }, tailOverruns{ 0 };
+
+    std::unique_ptr<Worker> worker;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConvolutionReverb)
+};
@@ -0,0 +1,167 @@
+#include "DelayEngine.h"
+
+// ── Tempo sync ────────────────────────────────────────────────────────────────
+juce::StringArray DelayEngine::getDivisionNames()
+{
+    return { "1/16", "1/8T", "1/8", "1/8D", "1/4T", "1/4", "1/4D", "1/2", "1/1" };
+}
+
+float DelayEngine::getSyncedDelaySeconds(double bpm, int division)
+{
+    static const float beats[NUM_DIVISIONS] = {
+        0.25f, 1.f / 3.f, 0.5f, 0.75f, 2.f / 3.f, 1.f, 1.5f, 2.f, 4.f
+    };
+    if (bpm <= 0.0)
+        bpm = 120.0;
+    auto seconds = (float)(60.0 / bpm) * beats[juce::jlimit(0, (int)NUM_DIVISIONS - 1, division)];
+    while (seconds > MAX_SYNC_SECONDS)
+        seconds *= 0.5f;
+    return seconds;
+}
+
+float DelayEngine::getTailSeconds(float delaySeconds, float feedback, float floorGain)
+{
+    // Echo n leaves the loop at feedback^(n - 1).
+    int echoes = 1;
+    if (feedback > 0.f)
+        echoes += (int)std::ceil(std::log(floorGain) / std::log(juce::jmin(feedback, 0.999f)));
+    return delaySeconds * (float)echoes;
+}
+
+// ── Setup ─────────────────────────────────────────────────────────────────────
+void DelayEngine::prepare(double sampleRate, int maxBlockSize, int numChannels, float maxDelaySeconds)
+{
+    sr        = sampleRate;
+    maxBlock  = juce::jmax(1, maxBlockSize);
+    length    = (int)std::ceil(sampleRate * maxDelaySeconds) + 4;
+    glideCoef = 1.f - std::exp(-1.f / (float)(sampleRate * 0.05));
+
+    numGroups = (juce::jmax(1, numChannels) + LANES - 1) / LANES;
+    ring.assign((size_t)(numGroups * (length + GUARD)), Vec::expand(0.f));
+    frames.assign((size_t)maxBlock, Vec::expand(0.f));
+    delayTimes.allocate((size_t)maxBlock, true);
+    reset();
+}
+
+void DelayEngine::reset()
+{
+    std::fill(ring.begin(), ring.end(), Vec::expand(0.f));
+    writePos     = 0;
+    currentDelay = targetDelay;
+    snapNext     = true;
+}
+
+void DelayEngine::setDelayTime(float seconds)
+{
+    targetDelay = juce::jlimit(1.f, (float)juce::jmax(1, length - 4), seconds * (float)sr);
+    if (snapNext)
+    {
+        currentDelay = targetDelay;
+        snapNext     = false;
+    }
+}
+
+void DelayEngine::fillDelayTimes(int numSamples) noexcept
+{
+    auto* d = delayTimes.get();
+    float c = currentDelay;
+    const float t = targetDelay;
+
+    if (c == t)
+    {
+        juce::FloatVectorOperations::fill(d, t, numSamples);
+        return;
+    }
+
+    const float k = glideCoef;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        c += (t - c) * k;
+        d[i] = c;
+    }
+    currentDelay = std::abs(t - c) < 1e-3f ? t : c;
+}
+
+// ── Process ───────────────────────────────────────────────────────────────────
+void DelayEngine::process(const juce::dsp::AudioBlock<float>& block,
+                          float mixStart, float mixEnd, float fbStart, float fbEnd)
+{
+    const int numCh   = juce::jmin((int)block.getNumChannels(), numGroups * LANES);
+    const int numSamp = (int)block.getNumSamples();
+    if (length <= 0 || numSamp <= 0) return;
+
+    const float mixStep = (mixEnd - mixStart) / (float)numSamp;
+    const float fbStep  = (fbEnd  - fbStart)  / (float)numSamp;
+    const float len     = (float)length;
+    auto*       raw     = reinterpret_cast<float*>(frames.data());
+
+    for (int start = 0; start < numSamp; start += maxBlock)
+    {
+        const int n = juce::jmin(maxBlock, numSamp - start);
+        fillDelayTimes(n);
+        const float* d = delayTimes.get();
+
+        int endPos = writePos;
+        for (int group = 0; group * LANES < numCh; ++group)
+        {
+            const int first = group * LANES;
+            const int lanes = juce::jmin(LANES, numCh - first);
+
+            for (int k = 0; k < LANES; ++k)
+            {
+                const auto* src = k < lanes ? block.getChannelPointer((size_t)(first + k)) + start : nullptr;
+                for (int i = 0; i < n; ++i)
+                    raw[i * LANES + k] = src != nullptr ? src[i] : 0.f;
+            }
+
+            Vec* data = frames.data();
+            Vec* buf  = ring.data() + (size_t)group * (size_t)(length + GUARD);
+            int  pos  = writePos;
+
+            for (int i = 0; i < n;)
+            {
+                // Segments stop at the wrap point, and separately at the end of
+                // the head region that is mirrored into the guard.
+                const bool mirror = pos < GUARD;
+                const int  seg    = juce::jmin(n - i, (mirror ? GUARD : length) - pos);
+
+                for (int k = 0; k < seg; ++k)
+                {
+                    const int j = i + k;
+
+                    float rp = (float)(pos + k - 1) - d[j];
+                    rp += rp < 0.f ? len : 0.f;
+                    const int   b = (int)rp;
+                    const float x = rp - (float)b;
+
+                    const Vec ym1 = buf[b], y0 = buf[b + 1], y1 = buf[b + 2], y2 = buf[b + 3];
+                    const Vec c1  = (y1 - ym1) * 0.5f;
+                    const Vec c2  = ym1 - y0 * 2.5f + y1 * 2.f - y2 * 0.5f;
+                    const Vec c3  = (y2 - ym1) * 0.5f + (y0 - y1) * 1.5f;
+                    const Vec wet = ((c3 * x + c2) * x + c1) * x + y0;
+
+                    const float t   = (float)(start + j);
+                    const Vec   dry = data[j];
+                    const Vec   in  = dry + wet * (fbStart + fbStep * t);
+
+                    buf[pos + k] = in;
+                    if (mirror) buf[length + pos + k] = in;
+                    data[j] = dry + wet * (mixStart + mixStep * t);
+                }
+
+                i   += seg;
+                pos += seg;
+                if (pos == length) pos = 0;
+            }
+            endPos = pos;
+
+            for (int k = 0; k < lanes; ++k)
+            {
+                auto* dst = block.getChannelPointer((size_t)(first + k)) + start;
+                for (int i = 0; i < n; ++i)
+                    dst[i] = raw[i * LANES + k];
+            }
+        }
+        writePos = endPos;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ─── Delay engine ────────────────────────────────────────────────────────────
+// Feedback delay with a fractional, gliding delay time. The block is walked
+// in contiguous segments split where the write head wraps, so there is no
+// per-sample modulo; reads use 4-point Hermite interpolation and a 3-sample
+// mirrored guard after the ring keeps the taps contiguous. The ring is sized
+// from the longest delay the caller asks for in prepare().
+// All channels share the delay time, so the ring stores one SIMDRegister of
+// channels per sample and each read/interpolate/write covers 4 or 8
+// channels; wider buses use one ring per group of lanes.
+class DelayEngine
+{
+public:
+    enum Division { d1_16, d1_8T, d1_8, d1_8D, d1_4T, d1_4, d1_4D, d1_2, d1_1, NUM_DIVISIONS };
+
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int LANES = (int)Vec::SIMDNumElements;
+
+    // Synced times longer than this are halved until they fit, so they stay on
+    // the beat grid while the ring only needs twice the delayTime range.
+    static constexpr float MAX_SYNC_SECONDS = 2.f;
+
+    static juce::StringArray getDivisionNames();
+    static float getSyncedDelaySeconds(double bpm, int division);
+
+    // Time for the echoes of a signal that just stopped to fall below floorGain.
+    static float getTailSeconds(float delaySeconds, float feedback, float floorGain);
+
+    void prepare(double sampleRate, int maxBlockSize, int numChannels, float maxDelaySeconds);
+    void reset();
+
+    // Target delay; the read head glides towards it.
+    void setDelayTime(float seconds);
+
+    // Mix and feedback are ramped linearly from start to end across the block.
+    void process(const juce::dsp::AudioBlock<float>& block,
+                 float mixStart, float mixEnd, float fbStart, float fbEnd);
+
+private:
+    static constexpr int GUARD = 3;
+
+    void fillDelayTimes(int numSamples) noexcept;
+
+    double sr = 44100.0;
+    int    maxBlock = 0;
+    int    length = 0;
+    int    writePos = 0;
+    int    numGroups = 0;
+
+    float currentDelay = 0.f, targetDelay = 0.f, glideCoef = 0.f;
+    bool  snapNext = true;
+
+    std::vector<Vec>       ring;     // numGroups x (length + GUARD)
+    std::vector<Vec>       frames;   // [sample][lane] for the group being processed
+    juce::HeapBlock<float> delayTimes;
+};
@@ -0,0 +1,116 @@
+#include "DspLoadMeter.h"
+
+DspLoadMeter::DspLoadMeter(int numStagesToTrack, const char* (*stageName)(int))
+    : numStages(juce::jlimit(1, MAX_STAGES, numStagesToTrack)), nameOf(stageName)
+{
+    clearCounters();
+}
+
+void DspLoadMeter::prepare(double sampleRate) noexcept
+{
+    sr.store(sampleRate);
+    calibCycles.store(readCycleCounter());
+    calibTicks.store(juce::Time::getHighResolutionTicks());
+    clearCounters();
+}
+
+void DspLoadMeter::clearCounters() noexcept
+{
+    for (auto& c : stages)
+    {
+        c.count.store(0, std::memory_order_relaxed);
+        c.sum.store(0, std::memory_order_relaxed);
+        c.min.store(~uint64_t(0), std::memory_order_relaxed);
+        c.max.store(0, std::memory_order_relaxed);
+        for (auto& b : c.bins) b.store(0, std::memory_order_relaxed);
+    }
+    samples.store(0, std::memory_order_relaxed);
+}
+
+// ── Histogram ─────────────────────────────────────────────────────────────────
+int DspLoadMeter::binFor(uint64_t cycles) noexcept
+{
+    if (cycles < 4) return (int)cycles;
+
+    int octave = 63;
+    while ((cycles >> octave) == 0) --octave;
+    const int sub = (int)((cycles >> (octave - 2)) & 3u);
+    return juce::jmin(NUM_BINS - 1, octave * 4 + sub);
+}
+
+double DspLoadMeter::binUpperEdge(int bin) noexcept
+{
+    if (bin < 4) return (double)(bin + 1);
+    const int octave = bin / 4, sub = bin % 4;
+    return std::ldexp(1.0 + (sub + 1) * 0.25, octave);
+}
+
+// ── Readout ───────────────────────────────────────────────────────────────────
+double DspLoadMeter::getCyclesPerSecond() const
+{
+    const double secs = juce::Time::highResolutionTicksToSeconds(
+        juce::Time::getHighResolutionTicks() - calibTicks.load());
+    if (secs < 0.01) return 0.0;
+    return (double)(readCycleCounter() - calibCycles.load()) / secs;
+}
+
+juce::String DspLoadMeter::getStageName(int stage) const
+{
+    return stage >= numStages ? juce::String("total") : juce::String(nameOf(stage));
+}
+
+DspLoadMeter::Stats DspLoadMeter::getStats(int stage) const
+{
+    Stats s;
+    const auto& c = stages[juce::jlimit(0, numStages, stage)];
+    const double cps = getCyclesPerSecond();
+    s.blocks = c.count.load(std::memory_order_relaxed);
+    if (cps <= 0.0 || s.blocks == 0) return s;
+
+    const double usPerCycle = 1e6 / cps;
+    const double sum        = (double)c.sum.load(std::memory_order_relaxed);
+    s.meanUs = sum / (double)s.blocks * usPerCycle;
+    s.minUs  = (double)c.min.load(std::memory_order_relaxed) * usPerCycle;
+    s.maxUs  = (double)c.max.load(std::memory_order_relaxed) * usPerCycle;
+
+    uint64_t binned = 0;
+    for (auto& b : c.bins) binned += b.load(std::memory_order_relaxed);
+    const uint64_t rank = binned - binned / 100;
+    uint64_t seen = 0;
+    for (int i = 0; i < NUM_BINS; ++i)
+    {
+        seen += c.bins[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            s.p99Us = juce::jmin(binUpperEdge(i) * usPerCycle, s.maxUs);
+            break;
+        }
+    }
+
+    const double audioSecs = (double)samples.load(std::memory_order_relaxed) / sr.load();
+    if (audioSecs > 0.0) s.loadPercent = 100.0 * (sum / cps) / audioSecs;
+    return s;
+}
+
+juce::var DspLoadMeter::toJson() const
+{
+    auto* root = new juce::DynamicObject();
+    root->setProperty("sample_rate", sr.load());
+    root->setProperty("cycles_per_second", getCyclesPerSecond());
+
+    auto* st = new juce::DynamicObject();
+    for (int i = 0; i <= numStages; ++i)
+    {
+        const auto s = getStats(i);
+        auto* o = new juce::DynamicObject();
+        o->setProperty("blocks", (juce::int64)s.blocks);
+        o->setProperty("mean_us", s.meanUs);
+        o->setProperty("min_us", s.minUs);
+        o->setProperty("max_us", s.maxUs);
+        o->setProperty("p99_us", s.p99Us);
+        o->setProperty("load_percent", s.loadPercent);
+        st->setProperty(getStageName(i), juce::var(o));
+    }
+    root->setProperty("stages", juce::var(st));
+    return juce::var(root);
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <JuceHeader.h>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+// Built into debug builds; release builds need -DKEROMIX_DSP_LOAD=1.
+#ifndef KEROMIX_DSP_LOAD
+ #if JUCE_DEBUG
+  #define KEROMIX_DSP_LOAD 1
+ #else
+  #define KEROMIX_DSP_LOAD 0
+ #endif
+#endif
+
+// ─── DSP load meter ──────────────────────────────────────────────────────────
+// Per-stage processBlock timings from the CPU cycle counter. The audio thread
+// is the only writer, so every counter is a plain relaxed load/store; readers
+// may see a stat a block out of date but never block the audio thread.
+// p99 comes from a quarter-octave histogram, so it is good to about 19 %.
+class DspLoadMeter
+{
+public:
+    static constexpr int MAX_STAGES = 8;
+
+    struct Stats
+    {
+        double   meanUs = 0.0, minUs = 0.0, maxUs = 0.0, p99Us = 0.0;
+        double   loadPercent = 0.0;   // share of realtime spent in this stage
+        uint64_t blocks = 0;
+    };
+
+    DspLoadMeter(int numStages, const char* (*stageName)(int));
+
+    static uint64_t readCycleCounter() noexcept
+    {
+       #if JUCE_INTEL
+        return (uint64_t)__rdtsc();
+       #elif JUCE_ARM && JUCE_64BIT && ! JUCE_MSVC
+        uint64_t v;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(v));
+        return v;
+       #else
+        return (uint64_t)juce::Time::getHighResolutionTicks();
+       #endif
+    }
+
+    // Audio thread
+    void prepare(double sampleRate) noexcept;
+
+    void blockStarted(int numSamples) noexcept
+    {
+        if (resetRequested.load(std::memory_order_relaxed))
+        {
+            clearCounters();
+            resetRequested.store(false, std::memory_order_relaxed);
+        }
+        relaxedAdd(samples, (uint64_t)numSamples);
+        blockStart = last = readCycleCounter();
+    }
+
+    void stageFinished(int stage) noexcept
+    {
+        const uint64_t now = readCycleCounter();
+        record(stages[stage], now - last);
+        last = now;
+    }
+
+    void blockFinished() noexcept { record(stages[numStages], last - blockStart); }
+
+    // Any thread. Index numStages holds the whole block.
+    int          getNumStages() const noexcept { return numStages; }
+    juce::String getStageName(int stage) const;
+    Stats        getStats(int stage) const;
+    void         requestReset() noexcept { resetRequested.store(true); }
+    juce::var    toJson() const;
+
+private:
+    static constexpr int NUM_BINS = 128;   // 32 octaves x 4
+
+    struct Counters
+    {
+        std::atomic<uint64_t> count{ 0 }, sum{ 0 }, min{ ~uint64_t(0) }, max{ 0 };
+        std::atomic<uint32_t> bins[NUM_BINS] = {};
+    };
+
+    template <typename T>
+    static void relaxedAdd(std::atomic<T>& a, T v) noexcept
+    {
+        a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+
+    static int binFor(uint64_t cycles) noexcept;
+    static double binUpperEdge(int bin) noexcept;
+
+    void record(Counters& c, uint64_t cycles) noexcept
+    {
+        relaxedAdd(c.count, (uint64_t)1);
+        relaxedAdd(c.sum, cycles);
+        if (cycles < c.min.load(std::memory_order_relaxed)) c.min.store(cycles, std::memory_order_relaxed);
+        if (cycles > c.max.load(std::memory_order_relaxed)) c.max.store(cycles, std::memory_order_relaxed);
+        relaxedAdd(c.bins[binFor(cycles)], (uint32_t)1);
+    }
+
+    void   clearCounters() noexcept;
+    double getCyclesPerSecond() const;
+
+    const int numStages;
+    const char* (*nameOf)(int);
+
+    Counters              stages[MAX_STAGES + 1];
+    std::atomic<uint64_t> samples{ 0 };
+    std::atomic<bool>     resetRequested{ false };
+    uint64_t              blockStart = 0, last = 0;
+
+    // Cycle counter calibration against the OS high-resolution clock.
+    std::atomic<double>      sr{ 44100.0 };
+    std::atomic<uint64_t>    calibCycles{ 0 };
+    std::atomic<juce::int64> calibTicks{ 0 };
+};
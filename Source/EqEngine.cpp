@@ -0,0 +1,144 @@
+#include "EqEngine.h"
+
+// ── Setup ─────────────────────────────────────────────────────────────────────
+void EqEngine::prepare(double sampleRate, int maxBlockSize, int numChannels)
+{
+    jassert(numChannels <= MAX_CHANNELS);
+    juce::ignoreUnused(numChannels);
+
+    sr       = sampleRate;
+    maxBlock = juce::jmax(1, maxBlockSize);
+    frames.assign((size_t)maxBlock, Vec::expand(0.f));
+
+    hasCached = false;
+    setParameters(cached);
+
+    for (int b = 0; b < NUM_BANDS; ++b)
+        for (int k = 0; k < NUM_COEFS; ++k)
+            coefs[b][k] = targets[b][k];
+    pending = false;
+
+    reset();
+}
+
+void EqEngine::reset()
+{
+    for (int g = 0; g < MAX_GROUPS; ++g)
+        for (int b = 0; b < NUM_BANDS; ++b)
+            s1[g][b] = s2[g][b] = Vec::expand(0.f);
+}
+
+void EqEngine::setBand(int band, const juce::IIRCoefficients& c)
+{
+    for (int k = 0; k < NUM_COEFS; ++k)
+        targets[band][k] = Vec::expand(c.coefficients[k]);
+    pending = true;
+}
+
+void EqEngine::setParameters(const Parameters& p)
+{
+    const bool all = !hasCached;
+
+    if (all || p.lowGainDb != cached.lowGainDb || p.lowFreq != cached.lowFreq)
+        setBand(0, juce::IIRCoefficients::makeLowShelf(sr, p.lowFreq, 0.71,
+                       juce::Decibels::decibelsToGain(p.lowGainDb)));
+
+    if (all || p.midGainDb != cached.midGainDb || p.midFreq != cached.midFreq || p.midQ != cached.midQ)
+        setBand(1, juce::IIRCoefficients::makePeakFilter(sr, p.midFreq, p.midQ,
+                       juce::Decibels::decibelsToGain(p.midGainDb)));
+
+    if (all || p.highGainDb != cached.highGainDb || p.highFreq != cached.highFreq)
+        setBand(2, juce::IIRCoefficients::makeHighShelf(sr, p.highFreq, 0.71,
+                       juce::Decibels::decibelsToGain(p.highGainDb)));
+
+    cached    = p;
+    hasCached = true;
+}
+
+// ── Process ───────────────────────────────────────────────────────────────────
+template <bool Interpolate>
+static void runCascade(EqEngine::Vec* x, int numSamples,
+                       EqEngine::Vec (&c)[3][5], const EqEngine::Vec (&dc)[3][5],
+                       EqEngine::Vec (&z1)[3], EqEngine::Vec (&z2)[3]) noexcept
+{
+    using Vec = EqEngine::Vec;
+    enum { B0, B1, B2, A1, A2 };
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        Vec v = x[i];
+        for (int b = 0; b < 3; ++b)
+        {
+            const Vec y = c[b][B0] * v + z1[b];
+            z1[b] = c[b][B1] * v - c[b][A1] * y + z2[b];
+            z2[b] = c[b][B2] * v - c[b][A2] * y;
+            v = y;
+        }
+        x[i] = v;
+
+        if (Interpolate)
+            for (int b = 0; b < 3; ++b)
+                for (int k = 0; k < 5; ++k)
+                    c[b][k] += dc[b][k];
+    }
+}
+
+void EqEngine::process(const juce::dsp::AudioBlock<float>& block)
+{
+    const int numCh   = juce::jmin((int)block.getNumChannels(), MAX_CHANNELS);
+    const int numSamp = (int)block.getNumSamples();
+    if (numCh <= 0 || numSamp <= 0 || maxBlock <= 0) return;
+
+    Vec delta[NUM_BANDS][NUM_COEFS] {};
+    const bool interpolate = pending;
+    if (interpolate)
+    {
+        const auto inv = Vec::expand(1.f / (float)numSamp);
+        for (int b = 0; b < NUM_BANDS; ++b)
+            for (int k = 0; k < NUM_COEFS; ++k)
+                delta[b][k] = (targets[b][k] - coefs[b][k]) * inv;
+    }
+
+    constexpr int W = LANES;
+    auto* raw = reinterpret_cast<float*>(frames.data());
+
+    for (int group = 0; group * W < numCh; ++group)
+    {
+        const int first = group * W;
+        const int lanes = juce::jmin(W, numCh - first);
+
+        // Every group starts from the same coefficients.
+        Vec c[NUM_BANDS][NUM_COEFS];
+        std::copy(&coefs[0][0], &coefs[0][0] + NUM_BANDS * NUM_COEFS, &c[0][0]);
+
+        for (int start = 0; start < numSamp; start += maxBlock)
+        {
+            const int n = juce::jmin(maxBlock, numSamp - start);
+
+            for (int k = 0; k < lanes; ++k)
+            {
+                const auto* src = block.getChannelPointer((size_t)(first + k)) + start;
+                for (int i = 0; i < n; ++i)
+                    raw[i * W + k] = src[i];
+            }
+
+            if (interpolate) runCascade<true> (frames.data(), n, c, delta, s1[group], s2[group]);
+            else             runCascade<false>(frames.data(), n, c, delta, s1[group], s2[group]);
+
+            for (int k = 0; k < lanes; ++k)
+            {
+                auto* dst = block.getChannelPointer((size_t)(first + k)) + start;
+                for (int i = 0; i < n; ++i)
+                    dst[i] = raw[i * W + k];
+            }
+        }
+    }
+
+    if (interpolate)
+    {
+        for (int b = 0; b < NUM_BANDS; ++b)
+            for (int k = 0; k < NUM_COEFS; ++k)
+                coefs[b][k] = targets[b][k];
+        pending = false;
+    }
+}
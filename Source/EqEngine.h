@@ -0,0 +1,52 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ─── 3-band EQ engine ────────────────────────────────────────────────────────
+// Low shelf -> peak -> high shelf, fused into a single pass over the block.
+// Channels sit side by side in the lanes of a SIMDRegister, 4 or 8 at a time
+// depending on the instruction set, and wider buses run one pass per group of
+// lanes. Each band is a transposed direct form II biquad, and the sample is
+// read and written once.
+// New coefficients are reached by per-sample linear interpolation across the
+// next process() call, so parameter moves never step the filter.
+class EqEngine
+{
+public:
+    struct Parameters
+    {
+        float lowGainDb  = 0.f, lowFreq  = 200.f;
+        float midGainDb  = 0.f, midFreq  = 1000.f, midQ = 0.8f;
+        float highGainDb = 0.f, highFreq = 8000.f;
+    };
+
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int LANES        = (int)Vec::SIMDNumElements;
+    static constexpr int MAX_CHANNELS = 16;
+
+    void prepare(double sampleRate, int maxBlockSize, int numChannels);
+    void reset();
+    void setParameters(const Parameters& p);
+
+    void process(const juce::dsp::AudioBlock<float>& block);
+
+private:
+    static constexpr int NUM_BANDS  = 3;
+    static constexpr int MAX_GROUPS = (MAX_CHANNELS + LANES - 1) / LANES;
+    enum { B0, B1, B2, A1, A2, NUM_COEFS };
+
+    void setBand(int band, const juce::IIRCoefficients& c);
+
+    double sr = 44100.0;
+    int    maxBlock = 0;
+
+    Parameters cached;
+    bool       hasCached = false;
+
+    Vec  coefs[NUM_BANDS][NUM_COEFS];
+    Vec  targets[NUM_BANDS][NUM_COEFS];
+    bool pending = false;
+
+    Vec s1[MAX_GROUPS][NUM_BANDS], s2[MAX_GROUPS][NUM_BANDS];
+
+    std::vector<Vec> frames;
+};
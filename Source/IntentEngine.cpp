@@ -0,0 +1,188 @@
+#include "IntentEngine.h"
+
+namespace
+{
+    // How the spectrum balance scales a move.
+    enum Shape
+    {
+        flat,
+        boostLow, cutLow,      // by low - mid
+        boostHigh, cutHigh,    // by high - mid, relative to a typical -8 dB
+        relax                  // move a fraction of the way to `neutral`
+    };
+
+    struct Move
+    {
+        const char* id = nullptr;
+        float       amount = 0.f;
+        Shape       shape = flat;
+        float       neutral = 0.f;
+    };
+
+    struct Intent
+    {
+        const char* name;
+        const char* stems[6];     // word prefixes
+        bool        invertible;   // "less reverb" makes sense, "less mud" already is
+        Move        moves[6];
+    };
+
+    const Intent intents[] =
+    {
+        { "warm",     { "warm" },                                        true,  { { "lowG", 1.5f, boostLow }, { "highG", -1.f } } },
+        { "bright",   { "bright", "crisp", "presen" },                  true,  { { "highG", 1.5f, boostHigh } } },
+        { "dark",     { "dark", "mellow" },                              true,  { { "highG", -1.5f, cutHigh } } },
+        { "punch",    { "punch" },                                       true,  { { "compRatio", 0.5f }, { "compThresh", -2.f } } },
+        { "compress", { "compress", "glue", "squash" },                  true,  { { "compRatio", 0.5f }, { "compThresh", -2.f }, { "compMakeup", 1.f } } },
+        { "air",      { "air", "spac", "wide", "open" },                 true,  { { "revMix", 0.08f }, { "revSize", 0.1f } } },
+        { "reverb",   { "reverb", "verb", "wet", "hall", "room" },       true,  { { "revMix", 0.1f } } },
+        { "delay",    { "delay", "echo" },                               true,  { { "delayMix", 0.08f } } },
+        { "dry",      { "dry", "clean" },                                false, { { "revMix", -0.1f }, { "delayMix", -0.1f } } },
+        { "mud",      { "mud", "boom", "boxy" },                         false, { { "lowG", -1.5f, cutLow }, { "midG", -1.f } } },
+        { "harsh",    { "harsh", "sibil", "shrill" },                    false, { { "highG", -1.5f, cutHigh } } },
+        { "loud",     { "loud" },                                        true,  { { "aimix", 0.05f } } },
+        { "quiet",    { "quiet" },                                       false, { { "aimix", -0.05f } } },
+        { "subtle",   { "subtle", "gentle", "natural" },                 false, { { "lowG", 0.3f, relax, 0.f }, { "midG", 0.3f, relax, 0.f },
+                                                                                  { "highG", 0.3f, relax, 0.f }, { "compRatio", 0.3f, relax, 1.f },
+                                                                                  { "revMix", 0.3f, relax, 0.f }, { "delayMix", 0.3f, relax, 0.f } } },
+    };
+
+    const char* const strongWords[]  = { "much", "lot", "lots", "very", "really", "way", "huge", "heavily" };
+    const char* const weakWords[]    = { "slightly", "slight", "bit", "little", "touch", "tad", "hint" };
+    const char* const negatorWords[] = { "less", "no", "not", "without", "remove", "reduce", "fewer", "kill", "cut",
+                                         "down", "off", "lower", "decrease", "drier" };
+
+    // Words that carry no intent of their own. Anything else the table does
+    // not know means the prompt asks for more than it can answer.
+    const char* const fillerWords[]  = { "a", "an", "the", "it", "its", "s", "this", "that", "my", "me", "i", "we",
+                                         "you", "please", "make", "turn", "set", "add", "give", "get", "bring",
+                                         "keep", "let", "lets", "want", "need", "can", "could", "would", "be",
+                                         "is", "more", "some", "up", "increase", "boost", "raise", "higher",
+                                         "extra", "mix", "sound", "overall", "just", "also", "too", "so", "to",
+                                         "of", "on", "in", "with", "for", "all" };
+
+    template <size_t N>
+    bool isOneOf(const juce::String& word, const char* const (&list)[N])
+    {
+        for (auto* w : list)
+            if (word == w) return true;
+        return false;
+    }
+
+    // Lower-case words; clause breaks (",", "&", "and", "but", ".") become "|".
+    juce::StringArray tokenise(const juce::String& prompt)
+    {
+        juce::StringArray words;
+        juce::String word;
+        auto flush = [&]() {
+            if (word == "and" || word == "but" || word == "then") words.add("|");
+            else if (word.isNotEmpty()) words.add(word);
+            word.clear();
+            };
+
+        const auto text = prompt.toLowerCase();
+        for (auto p = text.getCharPointer(); !p.isEmpty();)
+        {
+            const auto c = p.getAndAdvance();
+            if (juce::CharacterFunctions::isLetterOrDigit(c)) { word << juce::String::charToString(c); continue; }
+            flush();
+            if (c == ',' || c == '&' || c == '.' || c == ';') words.add("|");
+        }
+        flush();
+        return words;
+    }
+
+    const Intent* findIntent(const juce::String& word)
+    {
+        for (auto& intent : intents)
+            for (auto* stem : intent.stems)
+                if (stem != nullptr && word.startsWith(stem)) return &intent;
+        return nullptr;
+    }
+
+    bool isModifier(const juce::String& word)
+    {
+        return isOneOf(word, strongWords) || isOneOf(word, weakWords) || isOneOf(word, negatorWords);
+    }
+}
+
+IntentEngine::Result IntentEngine::interpret(const juce::String& prompt, const std::vector<Param>& params,
+                                             float lowDb, float midDb, float highDb)
+{
+    Result result;
+
+    // Spectrum tilt, neutral when there is no signal to judge by.
+    const bool  hasSpectrum = midDb > -59.f;
+    const float lowTilt  = hasSpectrum ? lowDb - midDb : 0.f;
+    const float highTilt = hasSpectrum ? highDb - midDb + 8.f : 0.f;
+    auto shapeFactor = [&](Shape shape) {
+        switch (shape)
+        {
+            case boostLow:  return juce::jlimit(0.25f, 1.5f, 1.f - lowTilt / 12.f);
+            case cutLow:    return juce::jlimit(0.5f, 2.f, 1.f + lowTilt / 12.f);
+            case boostHigh: return juce::jlimit(0.25f, 1.5f, 1.f - highTilt / 12.f);
+            case cutHigh:   return juce::jlimit(0.5f, 2.f, 1.f + highTilt / 12.f);
+            default:        return 1.f;
+        }
+        };
+
+    // Numbers ("300 ms") and unknown words go to the model untouched.
+    const auto words = tokenise(prompt);
+    for (auto& word : words)
+    {
+        if (word == "|" || isModifier(word) || isOneOf(word, fillerWords)) continue;
+        if (word.containsAnyOf("0123456789") || findIntent(word) == nullptr) return result;
+    }
+
+    // Modifiers apply to their whole clause, wherever they stand in it:
+    // "turn the reverb down" negates like "less reverb".
+    std::vector<float> delta(params.size(), 0.f);
+
+    for (int start = 0; start < words.size();)
+    {
+        int end = start;
+        while (end < words.size() && words[end] != "|") ++end;
+
+        float intensity = 1.f;
+        bool  negated = false;
+        for (int k = start; k < end; ++k)
+        {
+            if (isOneOf(words[k], strongWords))  intensity = 2.f;
+            if (isOneOf(words[k], weakWords))    intensity = 0.5f;
+            if (isOneOf(words[k], negatorWords)) negated = true;
+        }
+
+        for (int k = start; k < end; ++k)
+        {
+            if (isModifier(words[k]) || isOneOf(words[k], fillerWords)) continue;
+
+            const auto* intent = findIntent(words[k]);
+            if (intent == nullptr || result.intents.contains(intent->name)) continue;
+
+            const float sign = negated && intent->invertible ? -1.f : 1.f;
+            result.intents.add(intent->name);
+
+            for (auto& m : intent->moves)
+            {
+                if (m.id == nullptr) break;
+                for (size_t i = 0; i < params.size(); ++i)
+                {
+                    if (params[i].id != m.id || params[i].locked) continue;
+                    delta[i] += m.shape == relax ? (m.neutral - params[i].value) * juce::jmin(1.f, m.amount * intensity)
+                                                 : m.amount * shapeFactor(m.shape) * intensity * sign;
+                }
+            }
+        }
+        start = end + 1;
+    }
+
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+        if (delta[i] == 0.f) continue;
+        const auto& r = params[i].range;
+        const float value = juce::jlimit(r.start, r.end, params[i].value + delta[i]);
+        if (value != params[i].value)
+            result.changes.push_back({ params[i].id, value });
+    }
+    return result;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ─── Intent engine ───────────────────────────────────────────────────────────
+// Offline interpreter for simple mix requests ("Warmer", "Reduce mud",
+// "much more reverb"). The prompt is matched word by word against a table
+// of intents that encode the same rules as the AI system prompt (warm =
+// +lowG -highG, punchy = +compRatio -compThresh, ...). Each intent moves a
+// few parameters by small steps from their current values. The low/mid/high
+// spectrum balance scales the EQ moves. Modifiers scale every move in their
+// clause ("much", "a bit"), and a negator anywhere in it ("less", "down",
+// "turn off") inverts additive intents. Locked parameters are never touched.
+// Requests that match no intent, contain numbers or use words outside the
+// table are left to the remote model.
+class IntentEngine
+{
+public:
+    struct Param
+    {
+        juce::String                   id;
+        float                          value = 0.f;
+        juce::NormalisableRange<float> range;
+        bool                           locked = false;
+    };
+
+    struct Change { juce::String id; float value = 0.f; };
+
+    struct Result
+    {
+        juce::StringArray   intents;   // names of the matched intents
+        std::vector<Change> changes;   // target values, already clamped
+
+        bool isRecognised() const noexcept { return !intents.isEmpty(); }
+    };
+
+    // Spectrum levels are the long-term low/mid/high averages in dB.
+    static Result interpret(const juce::String& prompt, const std::vector<Param>& params,
+                            float lowDb, float midDb, float highDb);
+};
@@ -0,0 +1,210 @@
+#include "JsonReader.h"
+
+bool JsonReader::Token::is(const char* s) const noexcept
+{
+    return !escaped && std::strlen(s) == length && std::memcmp(text, s, length) == 0;
+}
+
+JsonReader::JsonReader(const char* data, size_t size) noexcept
+    : start(data), pos(data), end(data + size)
+{
+}
+
+JsonReader::JsonReader(const juce::String& s) noexcept
+    : JsonReader(s.toRawUTF8(), s.getNumBytesAsUTF8())
+{
+}
+
+// ── Tokens ────────────────────────────────────────────────────────────────────
+JsonReader::Token JsonReader::next() noexcept
+{
+    auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; };
+
+    while (pos < end && (isSpace(*pos) || *pos == ',' || *pos == ':')) ++pos;
+
+    Token t;
+    if (pos >= end) return t;
+
+    const char c = *pos;
+    t.text   = pos;
+    t.length = 1;
+
+    switch (c)
+    {
+        case '{': ++pos; ++depth; t.type = Type::objectStart; return t;
+        case '}': ++pos; --depth; t.type = Type::objectEnd;   return t;
+        case '[': ++pos; ++depth; t.type = Type::arrayStart;  return t;
+        case ']': ++pos; --depth; t.type = Type::arrayEnd;    return t;
+        default:  break;
+    }
+
+    if (c == '"')
+    {
+        const char* p = pos + 1;
+        while (p < end && *p != '"')
+        {
+            if (*p == '\\') { t.escaped = true; ++p; }
+            ++p;
+        }
+        if (p >= end) { pos = end; t.type = Type::error; return t; }
+
+        t.text   = pos + 1;
+        t.length = (size_t)(p - t.text);
+        pos = p + 1;
+
+        const char* q = pos;
+        while (q < end && isSpace(*q)) ++q;
+        if (q < end && *q == ':') { pos = q + 1; t.type = Type::key; }
+        else                      t.type = Type::string;
+        return t;
+    }
+
+    auto run = [&](auto&& accept) {
+        const char* p = pos;
+        while (p < end && accept(*p)) ++p;
+        t.length = (size_t)(p - pos);
+        pos = p;
+        };
+
+    if (c == '-' || c == '+' || c == '.' || (c >= '0' && c <= '9'))
+    {
+        run([](char x) { return (x >= '0' && x <= '9') || x == '.' || x == 'e' || x == 'E' || x == '+' || x == '-'; });
+        t.type = Type::number;
+        return t;
+    }
+    if (c >= 'a' && c <= 'z')
+    {
+        run([](char x) { return x >= 'a' && x <= 'z'; });
+        t.type = Type::literal;
+        return t;
+    }
+
+    pos = end;
+    t.type = Type::error;
+    return t;
+}
+
+// ── Values ────────────────────────────────────────────────────────────────────
+double JsonReader::toDouble(const Token& t) noexcept
+{
+    char buffer[64];
+    const size_t n = juce::jmin(t.length, sizeof(buffer) - 1);
+    std::memcpy(buffer, t.text, n);
+    buffer[n] = 0;
+
+    juce::CharPointer_ASCII p(buffer);
+    return juce::CharacterFunctions::readDoubleValue(p);
+}
+
+juce::String JsonReader::toString(const Token& t)
+{
+    if (!t.escaped) return juce::String::fromUTF8(t.text, (int)t.length);
+
+    std::string out;
+    out.reserve(t.length);
+
+    auto hex4 = [&](size_t i) -> int {
+        if (i + 4 > t.length) return -1;
+        int v = 0;
+        for (size_t k = i; k < i + 4; ++k)
+        {
+            const int d = juce::CharacterFunctions::getHexDigitValue((juce::juce_wchar)(uint8_t)t.text[k]);
+            if (d < 0) return -1;
+            v = v * 16 + d;
+        }
+        return v;
+        };
+    auto putUtf8 = [&](uint32_t cp) {
+        if (cp < 0x80)         out += (char)cp;
+        else if (cp < 0x800)   { out += (char)(0xc0 | (cp >> 6));  out += (char)(0x80 | (cp & 0x3f)); }
+        else if (cp < 0x10000) { out += (char)(0xe0 | (cp >> 12)); out += (char)(0x80 | ((cp >> 6) & 0x3f));
+                                 out += (char)(0x80 | (cp & 0x3f)); }
+        else                   { out += (char)(0xf0 | (cp >> 18)); out += (char)(0x80 | ((cp >> 12) & 0x3f));
+                                 out += (char)(0x80 | ((cp >> 6) & 0x3f)); out += (char)(0x80 | (cp & 0x3f)); }
+        };
+
+    for (size_t i = 0; i < t.length; ++i)
+    {
+        const char c = t.text[i];
+        if (c != '\\' || i + 1 >= t.length) { out += c; continue; }
+
+        switch (t.text[++i])
+        {
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u':
+            {
+                int cp = hex4(i + 1);
+                if (cp < 0) break;
+                i += 4;
+                // Surrogate pair.
+                if (cp >= 0xd800 && cp < 0xdc00 && i + 2 < t.length && t.text[i + 1] == '\\' && t.text[i + 2] == 'u')
+                {
+                    const int low = hex4(i + 3);
+                    if (low >= 0xdc00 && low < 0xe000)
+                    {
+                        cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                        i += 6;
+                    }
+                }
+                putUtf8((uint32_t)cp);
+                break;
+            }
+            default: out += t.text[i]; break;   // \" \\ \/
+        }
+    }
+    return juce::String::fromUTF8(out.data(), (int)out.size());
+}
+
+// ── Param lookup ──────────────────────────────────────────────────────────────
+uint32_t ParamLookup::hash(const char* s, size_t length, uint32_t seed) noexcept
+{
+    uint32_t h = 2166136261u ^ (seed * 0x9e3779b9u);
+    for (size_t i = 0; i < length; ++i)
+    {
+        h ^= (uint8_t)s[i];
+        h *= 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+ParamLookup::ParamLookup(const juce::String* ids, int numIds)
+{
+    for (int i = 0; i < numIds; ++i)
+        names.push_back(ids[i].toStdString());
+
+    // Smallest table, then first seed, that gives every ID its own slot.
+    for (uint32_t size = (uint32_t)juce::nextPowerOfTwo(juce::jmax(2, numIds * 2));; size *= 2)
+    {
+        for (uint32_t s = 1; s <= 4096; ++s)
+        {
+            slots.assign(size, -1);
+            bool ok = true;
+            for (int i = 0; i < numIds && ok; ++i)
+            {
+                auto& slot = slots[hash(names[(size_t)i].data(), names[(size_t)i].size(), s) & (size - 1)];
+                ok = slot < 0;
+                slot = i;
+            }
+            if (ok)
+            {
+                seed = s;
+                mask = size - 1;
+                return;
+            }
+        }
+    }
+}
+
+int ParamLookup::find(const char* name, size_t length) const noexcept
+{
+    if (slots.empty()) return -1;
+    const int i = slots[hash(name, length, seed) & mask];
+    if (i < 0) return -1;
+
+    const auto& n = names[(size_t)i];
+    return n.size() == length && std::memcmp(n.data(), name, length) == 0 ? i : -1;
+}
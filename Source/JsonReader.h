@@ -0,0 +1,65 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ─── JSON reader ─────────────────────────────────────────────────────────────
+// Single-pass, zero-copy tokenizer for the AI responses. Tokens point into
+// the caller's buffer: strings are handed out with their escapes still in
+// place and only decoded on request, numbers are converted on request. A
+// string followed by ':' is reported as a key, and commas and colons never
+// appear as tokens. There is no tree, so a response costs one walk and no
+// allocations. The buffer must outlive the reader.
+class JsonReader
+{
+public:
+    enum class Type { objectStart, objectEnd, arrayStart, arrayEnd, key, string, number, literal, end, error };
+
+    struct Token
+    {
+        Type        type = Type::end;
+        const char* text = nullptr;    // strings and keys: without the quotes
+        size_t      length = 0;
+        bool        escaped = false;   // contains backslash escapes
+
+        bool is(const char* s) const noexcept;
+    };
+
+    JsonReader(const char* data, size_t size) noexcept;
+    explicit JsonReader(const juce::String& s) noexcept;
+
+    Token next() noexcept;
+
+    // Objects and arrays currently open.
+    int getDepth() const noexcept { return depth; }
+
+    // Offset just past the last token read.
+    size_t getPosition() const noexcept { return (size_t)(pos - start); }
+
+    static double       toDouble(const Token& t) noexcept;
+    static juce::String toString(const Token& t);   // decodes escapes
+
+private:
+    const char* start;
+    const char* pos;
+    const char* end;
+    int         depth = 0;
+};
+
+// ─── Param lookup ────────────────────────────────────────────────────────────
+// Perfect hash over a fixed set of parameter IDs: each ID owns a slot, so a
+// key read from JSON is resolved with one hash and one compare.
+class ParamLookup
+{
+public:
+    ParamLookup(const juce::String* ids, int numIds);
+
+    // Index into the ids the table was built from, or -1.
+    int find(const char* name, size_t length) const noexcept;
+    int find(const juce::String& name) const noexcept { return find(name.toRawUTF8(), name.getNumBytesAsUTF8()); }
+
+private:
+    static uint32_t hash(const char* s, size_t length, uint32_t seed) noexcept;
+
+    std::vector<std::string> names;
+    std::vector<int>         slots;   // -1 = empty
+    uint32_t                 seed = 0, mask = 0;
+};
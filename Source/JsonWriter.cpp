@@ -0,0 +1,142 @@
+#include "JsonWriter.h"
+
+JsonWriter::JsonWriter(size_t initialCapacity)
+{
+    buffer.reserve(initialCapacity);
+}
+
+void JsonWriter::reset() noexcept
+{
+    buffer.clear();
+    depth = 0;
+    afterKey = false;
+    hasItems[0] = false;
+}
+
+// ── Structure ─────────────────────────────────────────────────────────────────
+void JsonWriter::separate()
+{
+    if (afterKey) { afterKey = false; return; }
+    if (hasItems[depth]) buffer += ',';
+    hasItems[depth] = true;
+}
+
+void JsonWriter::open(char c)
+{
+    separate();
+    buffer += c;
+    jassert(depth + 1 < MAX_DEPTH);
+    depth = juce::jmin(depth + 1, MAX_DEPTH - 1);
+    hasItems[depth] = false;
+}
+
+void JsonWriter::close(char c)
+{
+    jassert(depth > 0 && !afterKey);
+    buffer += c;
+    depth = juce::jmax(0, depth - 1);
+}
+
+JsonWriter& JsonWriter::beginObject() { open('{');  return *this; }
+JsonWriter& JsonWriter::endObject()   { close('}'); return *this; }
+JsonWriter& JsonWriter::beginArray()  { open('[');  return *this; }
+JsonWriter& JsonWriter::endArray()    { close(']'); return *this; }
+
+JsonWriter& JsonWriter::key(const char* name)
+{
+    separate();
+    buffer += '"';
+    escape(name, std::strlen(name));
+    buffer += "\":";
+    afterKey = true;
+    return *this;
+}
+
+// ── Values ────────────────────────────────────────────────────────────────────
+JsonWriter& JsonWriter::value(const juce::String& s) { return beginString().append(s).endString(); }
+JsonWriter& JsonWriter::value(const char* s)         { return beginString().append(s).endString(); }
+
+JsonWriter& JsonWriter::value(double v)
+{
+    separate();
+    if (!std::isfinite(v)) { buffer += "null"; return *this; }
+
+    char text[32];
+    const int n = std::snprintf(text, sizeof(text), "%.6g", v);
+    for (int i = 0; i < n; ++i)
+        if (text[i] == ',') text[i] = '.';   // decimal comma locales
+    put(text, (size_t)juce::jlimit(0, (int)sizeof(text) - 1, n));
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(int v)
+{
+    separate();
+    char text[16];
+    const int n = std::snprintf(text, sizeof(text), "%d", v);
+    put(text, (size_t)juce::jlimit(0, (int)sizeof(text) - 1, n));
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool v)
+{
+    separate();
+    buffer += v ? "true" : "false";
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginString()
+{
+    separate();
+    buffer += '"';
+    return *this;
+}
+
+JsonWriter& JsonWriter::append(const juce::String& s)
+{
+    escape(s.toRawUTF8(), s.getNumBytesAsUTF8());
+    return *this;
+}
+
+JsonWriter& JsonWriter::append(const char* s)
+{
+    escape(s, std::strlen(s));
+    return *this;
+}
+
+JsonWriter& JsonWriter::endString()
+{
+    buffer += '"';
+    return *this;
+}
+
+void JsonWriter::escape(const char* s, size_t n)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    size_t runStart = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const auto c = (uint8_t)s[i];
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        put(s + runStart, i - runStart);
+        runStart = i + 1;
+
+        switch (c)
+        {
+            case '"':  buffer += "\\\""; break;
+            case '\\': buffer += "\\\\"; break;
+            case '\n': buffer += "\\n";  break;
+            case '\r': buffer += "\\r";  break;
+            case '\t': buffer += "\\t";  break;
+            default:
+            {
+                const char u[] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 15] };
+                put(u, sizeof(u));
+                break;
+            }
+        }
+    }
+    put(s + runStart, n - runStart);
+}
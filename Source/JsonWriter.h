@@ -0,0 +1,52 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ─── JSON writer ─────────────────────────────────────────────────────────────
+// Serialises a request straight into one growable buffer that keeps its
+// capacity between requests, so building a body doesn't allocate once the
+// buffer has warmed up. Commas are inserted automatically. Strings are
+// escaped as they are copied, and a string value can be written in pieces
+// (beginString / append / endString). Numbers are always written with '.'.
+class JsonWriter
+{
+public:
+    explicit JsonWriter(size_t initialCapacity = 16384);
+
+    void reset() noexcept;   // empties the buffer, keeps its capacity
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+    JsonWriter& key(const char* name);
+
+    JsonWriter& value(const juce::String& s);
+    JsonWriter& value(const char* s);
+    JsonWriter& value(double v);
+    JsonWriter& value(int v);
+    JsonWriter& value(bool v);
+
+    JsonWriter& beginString();
+    JsonWriter& append(const juce::String& s);
+    JsonWriter& append(const char* s);
+    JsonWriter& endString();
+
+    const char* getData() const noexcept { return buffer.data(); }
+    size_t      getSize() const noexcept { return buffer.size(); }
+
+    juce::MemoryBlock toMemoryBlock() const { return { buffer.data(), buffer.size() }; }
+
+private:
+    static constexpr int MAX_DEPTH = 32;
+
+    void separate();
+    void open(char c);
+    void close(char c);
+    void put(const char* s, size_t n) { buffer.append(s, n); }
+    void escape(const char* s, size_t n);
+
+    std::string buffer;
+    bool        hasItems[MAX_DEPTH] = {};
+    int         depth = 0;
+    bool        afterKey = false;
+};
@@ -0,0 +1,171 @@
+#include "LlmStream.h"
+#include "JsonReader.h"
+
+void LlmStream::read(juce::InputStream& in, const std::function<bool()>& shouldStop)
+{
+    char buffer[64];
+    while (!done && !shouldStop())
+    {
+        const int n = in.read(buffer, (int)sizeof(buffer));
+        if (n <= 0) break;
+        feed(buffer, (size_t)n);
+    }
+    finish();
+}
+
+// ── Server-sent events ────────────────────────────────────────────────────────
+void LlmStream::feed(const char* data, size_t numBytes)
+{
+    raw.write(data, numBytes);
+
+    for (size_t i = 0; i < numBytes && !done; ++i)
+    {
+        if (data[i] != '\n')
+        {
+            pendingLine.push_back(data[i]);
+            continue;
+        }
+        if (!pendingLine.empty() && pendingLine.back() == '\r') pendingLine.pop_back();
+        handleLine(juce::String::fromUTF8(pendingLine.data(), (int)pendingLine.size()));
+        pendingLine.clear();
+    }
+}
+
+void LlmStream::finish()
+{
+    if (!pendingLine.empty())
+    {
+        handleLine(juce::String::fromUTF8(pendingLine.data(), (int)pendingLine.size()).trimCharactersAtEnd("\r"));
+        pendingLine.clear();
+    }
+    handleLine({});
+}
+
+void LlmStream::handleLine(const juce::String& line)
+{
+    if (line.isEmpty())
+    {
+        if (eventData.isNotEmpty()) handleEvent();
+        eventData.clear();
+        return;
+    }
+    if (!line.startsWith("data:")) return;   // comments, event names, ids
+
+    auto value = line.substring(5);
+    if (value.startsWithChar(' ')) value = value.substring(1);
+    eventData << (eventData.isEmpty() ? "" : "\n") << value;
+}
+
+void LlmStream::handleEvent()
+{
+    ++numEvents;
+    if (eventData.trim() == "[DONE]")
+    {
+        done = true;
+        return;
+    }
+
+    // choices[0].delta.content; chunks carry only one choice.
+    JsonReader reader(eventData);
+    JsonReader::Token t;
+    do t = reader.next();
+    while (t.type != JsonReader::Type::end && t.type != JsonReader::Type::error
+           && !(t.type == JsonReader::Type::key && t.is("content")));
+
+    const auto delta = reader.next();
+    if (t.type != JsonReader::Type::key || delta.type != JsonReader::Type::string) return;
+
+    const auto text = JsonReader::toString(delta);
+    content << text;
+    for (auto p = text.getCharPointer(); !p.isEmpty();)
+        scan(p.getAndAdvance());
+}
+
+// ── Object scanner ────────────────────────────────────────────────────────────
+juce::String LlmStream::getObject() const
+{
+    return objectEnd > objectStart ? content.substring(objectStart, objectEnd + 1) : juce::String();
+}
+
+void LlmStream::emitNumber()
+{
+    if (number.containsAnyOf("0123456789") && number.containsOnly("0123456789.-+eE") && onParameter)
+        onParameter(key, number.getFloatValue());
+    number.clear();
+}
+
+void LlmStream::scan(juce::juce_wchar c)
+{
+    const int pos = position++;
+
+    switch (state)
+    {
+        case seekObject:
+            if (c == '{') { objectStart = pos; state = seekKey; }
+            break;
+
+        case seekKey:
+            if (c == '"')      { key.clear(); escaped = false; state = inKey; }
+            else if (c == '}') { objectEnd = pos; state = finished; }
+            break;
+
+        case inKey:
+            if (escaped)        { key << juce::String::charToString(c); escaped = false; }
+            else if (c == '\\') escaped = true;
+            else if (c == '"')  state = seekColon;
+            else                key << juce::String::charToString(c);
+            break;
+
+        case seekColon:
+            if (c == ':') state = seekValue;
+            break;
+
+        case seekValue:
+            if (juce::CharacterFunctions::isWhitespace(c)) break;
+            if (c == '-' || c == '+' || c == '.' || juce::CharacterFunctions::isDigit(c))
+            {
+                number = juce::String::charToString(c);
+                state  = inNumber;
+                break;
+            }
+            skipDepth = 0;
+            inString  = false;
+            escaped   = false;
+            state     = skipValue;
+            --position;
+            scan(c);
+            break;
+
+        case inNumber:
+            if (juce::CharacterFunctions::isDigit(c) || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')
+            {
+                number << juce::String::charToString(c);
+                break;
+            }
+            emitNumber();
+            state = seekKey;
+            --position;
+            scan(c);
+            break;
+
+        case skipValue:
+            if (inString)
+            {
+                if (escaped)        escaped = false;
+                else if (c == '\\') escaped = true;
+                else if (c == '"')  { inString = false; if (skipDepth == 0) state = seekKey; }
+            }
+            else if (c == '"')             inString = true;
+            else if (c == '{' || c == '[') ++skipDepth;
+            else if (c == '}' || c == ']')
+            {
+                if (skipDepth == 0) { state = seekKey; --position; scan(c); }   // closes our object
+                else if (--skipDepth == 0) state = seekKey;
+            }
+            else if (c == ',' && skipDepth == 0) state = seekKey;
+            break;
+
+        case finished:
+            break;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ─── LLM stream ──────────────────────────────────────────────────────────────
+// Incremental parser for an OpenAI-style chat completion streamed as
+// server-sent events ("stream": true). Raw bytes go in as they arrive. Each
+// event's delta content is appended to the model text, which is scanned
+// character by character for the first JSON object. Every "key": number pair
+// is reported as soon as its number is terminated, long before the
+// completion ends. Non-numeric values are skipped. Nothing here touches the
+// network, so any InputStream (or a local stand-in server) can drive it.
+class LlmStream
+{
+public:
+    std::function<void(const juce::String& key, float value)> onParameter;
+
+    // Reads until the stream ends, "[DONE]" arrives or shouldStop() is true.
+    // Small reads keep blocking input streams from holding back events.
+    void read(juce::InputStream& in, const std::function<bool()>& shouldStop);
+
+    void feed(const char* data, size_t numBytes);
+    void finish();
+
+    bool hasEvents() const noexcept { return numEvents > 0; }
+    bool isDone() const noexcept    { return done; }
+
+    const juce::String& getContent() const noexcept { return content; }
+
+    // The first complete top-level object in the model text, or empty.
+    juce::String getObject() const;
+
+    // Everything fed so far, for diagnostics when no events were found.
+    juce::String getRaw() const { return raw.toString(); }
+
+private:
+    void handleLine(const juce::String& line);
+    void handleEvent();
+    void scan(juce::juce_wchar c);
+    void emitNumber();
+
+    std::string             pendingLine;
+    juce::String            eventData;
+    juce::MemoryOutputStream raw;
+    int                     numEvents = 0;
+    bool                    done = false;
+
+    // ── Object scanner ────────────────────────────────────────────────────
+    enum State { seekObject, seekKey, inKey, seekColon, seekValue, inNumber, skipValue, finished };
+
+    juce::String content, key, number;
+    State state = seekObject;
+    int   position = 0, objectStart = -1, objectEnd = -1;
+    int   skipDepth = 0;
+    bool  inString = false, escaped = false;
+};
@@ -0,0 +1,108 @@
+#include "MorphEngine.h"
+
+using P = ParameterSnapshot;
+
+// ── Curves ────────────────────────────────────────────────────────────────────
+const MorphEngine::Curve MorphEngine::curves[ParameterSnapshot::NUM_IDS] = {
+    Curve::linear,       // lowG
+    Curve::logarithmic,  // lowFreq
+    Curve::linear,       // midG
+    Curve::logarithmic,  // midFreq
+    Curve::logarithmic,  // midQ
+    Curve::linear,       // highG
+    Curve::logarithmic,  // highFreq
+    Curve::linear,       // compThresh
+    Curve::logarithmic,  // compRatio
+    Curve::logarithmic,  // compAttack
+    Curve::logarithmic,  // compRelease
+    Curve::linear,       // compMakeup
+    Curve::logarithmic,  // delayTime
+    Curve::linear,       // delayFeedback
+    Curve::linear,       // delayMix
+    Curve::linear,       // revDecay
+    Curve::linear,       // revSize
+    Curve::linear,       // revDamp
+    Curve::linear,       // revMix
+    Curve::linear,       // aimix
+    Curve::linear,       // compKnee
+    Curve::step,         // compLink
+    Curve::step,         // delaySync
+    Curve::step,         // delayDiv
+    Curve::step,         // revMode
+    Curve::step,         // osFactor
+    Curve::step,         // osQuality
+    Curve::step,         // compLinkScope
+    Curve::linear        // morph (never morphed)
+};
+
+float MorphEngine::blend(Curve curve, float a, float b, float t) noexcept
+{
+    switch (curve)
+    {
+        case Curve::step:        return t < 0.5f ? a : b;
+        case Curve::logarithmic: if (a > 0.f && b > 0.f) return a * std::pow(b / a, t);
+                                 break;
+        case Curve::linear:      break;
+    }
+    return a + (b - a) * t;
+}
+
+// ── Message thread ────────────────────────────────────────────────────────────
+void MorphEngine::setStates(const std::vector<State>& states, const State& current)
+{
+    auto& s = scenes[back];
+    s.numStates = juce::jmin((int)states.size(), MAX_STATES);
+    s.current   = current;
+    s.mask      = 0;
+    if (s.numStates < 2) s.numStates = 0;
+
+    for (int n = 0; n < s.numStates; ++n)
+        s.states[n] = states[(size_t)n];
+
+    for (int i = 0; i < P::NUM_IDS; ++i)
+        for (int n = 1; n < s.numStates; ++n)
+            if (i != P::morph && s.states[n][(size_t)i] != s.states[0][(size_t)i])
+                s.mask |= P::bit((P::Id)i);
+
+    numStates = s.numStates;
+    back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & ~FRESH;
+}
+
+// ── Audio thread ──────────────────────────────────────────────────────────────
+uint32_t MorphEngine::process(ParameterSnapshot& params) noexcept
+{
+    bool fresh = false;
+    if ((middle.load(std::memory_order_relaxed) & FRESH) != 0)
+    {
+        front  = middle.exchange(front, std::memory_order_acq_rel) & ~FRESH;
+        active = scenes[front].mask;
+        fresh  = true;
+    }
+    const auto& s = scenes[front];
+
+    uint32_t kept = active;
+    for (int i = 0; i < P::NUM_IDS && kept != 0; ++i)
+        if ((active & P::bit((P::Id)i)) != 0 && params.getRaw((P::Id)i) != s.current[(size_t)i])
+            kept &= ~P::bit((P::Id)i);
+
+    if (fresh || kept != active)
+    {
+        active = kept;
+        params.setOverrides(active);
+    }
+    if (active == 0) return 0;
+
+    const float pos = juce::jlimit(0.f, 1.f, params.getTarget(P::morph));
+    if (pos == position && !fresh) return 0;
+    position = pos;
+
+    const float x = pos * (float)(s.numStates - 1);
+    const int   k = juce::jmin((int)x, s.numStates - 2);
+    const float t = x - (float)k;
+
+    uint32_t changed = 0;
+    for (int i = 0; i < P::NUM_IDS; ++i)
+        if ((active & P::bit((P::Id)i)) != 0)
+            changed |= params.retarget((P::Id)i, blend(curves[i], s.states[k][(size_t)i], s.states[k + 1][(size_t)i], t));
+    return changed;
+}
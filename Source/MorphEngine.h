@@ -0,0 +1,64 @@
+#pragma once
+#include <JuceHeader.h>
+#include "ParameterSnapshot.h"
+
+// ─── Morph engine ────────────────────────────────────────────────────────────
+// Blends two to MAX_STATES stored parameter states. The automatable "morph"
+// parameter walks through them in order (with three states, 0.5 is the
+// middle one). Every parameter blends along its own curve: log for
+// frequencies, Q, ratio and times, linear for dB gains and mixes; switches
+// flip halfway between two states.
+//
+// The engine never touches the DSP. It overrides the ParameterSnapshot
+// targets of the ids that differ between states, and the snapshot's ramps
+// glide there sample by sample exactly as they do for automation, so a
+// morph sweep costs the same coefficient updates. An id the user or host
+// moves while morphing drops out of the morph and follows its parameter.
+//
+// States are handed to the audio thread through a triple buffer: setting
+// them never waits and the audio thread always sees the newest set.
+class MorphEngine
+{
+public:
+    static constexpr int MAX_STATES = 4;
+    using State = std::array<float, ParameterSnapshot::NUM_IDS>;   // plain values
+
+    MorphEngine() = default;
+
+    // Message thread. Fewer than two states ends the morph. `current` holds
+    // the parameter values at this moment; an id whose parameter later
+    // differs from it leaves the morph.
+    void setStates(const std::vector<State>& states, const State& current);
+    int  getNumStates() const noexcept { return numStates; }
+
+    // Audio thread, once per block after ParameterSnapshot::update(). Returns
+    // the ids whose targets moved.
+    uint32_t process(ParameterSnapshot& params) noexcept;
+    void     reset() noexcept { position = -1.f; }
+
+private:
+    enum class Curve { linear, logarithmic, step };
+    static const Curve curves[ParameterSnapshot::NUM_IDS];
+    static float blend(Curve curve, float a, float b, float t) noexcept;
+
+    struct Scene
+    {
+        int      numStates = 0;
+        uint32_t mask = 0;                 // ids that differ between states
+        State    states[MAX_STATES] = {};
+        State    current = {};
+    };
+
+    // `back` belongs to the message thread and `front` to the audio thread;
+    // publishing swaps `back` with the middle slot and sets FRESH.
+    static constexpr int FRESH = 4;
+    Scene            scenes[3];
+    int              back = 0, front = 1;
+    std::atomic<int> middle{ 2 };
+
+    int      numStates = 0;                // message thread
+    uint32_t active = 0;                   // audio thread: ids still morphing
+    float    position = -1.f;
+
+    JUCE_DECLARE_NON_COPYABLE(MorphEngine)
+};
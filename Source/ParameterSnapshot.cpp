@@ -0,0 +1,255 @@
+#include "ParameterSnapshot.h"
+
+static_assert(ParameterSnapshot::NUM_IDS < 32, "change masks are 32-bit");
+
+const char* const ParameterSnapshot::paramIDs[NUM_IDS] = {
+    "lowG","lowFreq","midG","midFreq","midQ","highG","highFreq",
+    "compThresh","compRatio","compAttack","compRelease","compMakeup",
+    "delayTime","delayFeedback","delayMix",
+    "revDecay","revSize","revDamp","revMix",
+    "aimix",
+    "compKnee","compLink",
+    "delaySync","delayDiv",
+    "revMode",
+    "osFactor","osQuality",
+    "compLinkScope",
+    "morph"
+};
+
+// Reverb params are smoothed inside juce::Reverb, attack/release only move
+// time constants, the delay engine glides its own delay time and the rest
+// are switches.
+static const ParameterSnapshot::RampKind kRampKinds[ParameterSnapshot::NUM_IDS] = {
+    ParameterSnapshot::RampKind::linear,         // lowG
+    ParameterSnapshot::RampKind::multiplicative, // lowFreq
+    ParameterSnapshot::RampKind::linear,         // midG
+    ParameterSnapshot::RampKind::multiplicative, // midFreq
+    ParameterSnapshot::RampKind::multiplicative, // midQ
+    ParameterSnapshot::RampKind::linear,         // highG
+    ParameterSnapshot::RampKind::multiplicative, // highFreq
+    ParameterSnapshot::RampKind::linear,         // compThresh
+    ParameterSnapshot::RampKind::multiplicative, // compRatio
+    ParameterSnapshot::RampKind::snap,           // compAttack
+    ParameterSnapshot::RampKind::snap,           // compRelease
+    ParameterSnapshot::RampKind::linear,         // compMakeup
+    ParameterSnapshot::RampKind::snap,           // delayTime
+    ParameterSnapshot::RampKind::linear,         // delayFeedback
+    ParameterSnapshot::RampKind::linear,         // delayMix
+    ParameterSnapshot::RampKind::snap,           // revDecay
+    ParameterSnapshot::RampKind::snap,           // revSize
+    ParameterSnapshot::RampKind::snap,           // revDamp
+    ParameterSnapshot::RampKind::snap,           // revMix
+    ParameterSnapshot::RampKind::linear,         // aimix
+    ParameterSnapshot::RampKind::linear,         // compKnee
+    ParameterSnapshot::RampKind::snap,           // compLink
+    ParameterSnapshot::RampKind::snap,           // delaySync
+    ParameterSnapshot::RampKind::snap,           // delayDiv
+    ParameterSnapshot::RampKind::snap,           // revMode
+    ParameterSnapshot::RampKind::snap,           // osFactor
+    ParameterSnapshot::RampKind::snap,           // osQuality
+    ParameterSnapshot::RampKind::snap,           // compLinkScope
+    ParameterSnapshot::RampKind::linear          // morph
+};
+
+// ── Ramp ──────────────────────────────────────────────────────────────────────
+void ParameterSnapshot::Ramp::setTarget(float newTarget, int length) noexcept
+{
+    target = newTarget;
+
+    if (kind == RampKind::snap || length <= 0 || current == newTarget
+        || (kind == RampKind::multiplicative && (current <= 0.f || newTarget <= 0.f)))
+    {
+        current   = newTarget;
+        countdown = 0;
+        return;
+    }
+
+    countdown = length;
+    step = kind == RampKind::multiplicative
+         ? std::exp((std::log(newTarget) - std::log(current)) / (float)length)
+         : (newTarget - current) / (float)length;
+}
+
+float ParameterSnapshot::Ramp::next() noexcept
+{
+    if (countdown <= 0) return target;
+
+    if (--countdown == 0)                       current = target;
+    else if (kind == RampKind::multiplicative)  current *= step;
+    else                                        current += step;
+    return current;
+}
+
+void ParameterSnapshot::Ramp::skip(int numSamples) noexcept
+{
+    if (countdown <= 0) return;
+
+    if (numSamples >= countdown)
+    {
+        current   = target;
+        countdown = 0;
+        return;
+    }
+
+    countdown -= numSamples;
+    if (kind == RampKind::multiplicative) current *= std::pow(step, (float)numSamples);
+    else                                  current += step * (float)numSamples;
+}
+
+// ── Snapshot ──────────────────────────────────────────────────────────────────
+ParameterSnapshot::ParameterSnapshot(juce::AudioProcessorValueTreeState& state)
+    : apvts(state)
+{
+    for (int i = 0; i < NUM_IDS; ++i)
+    {
+        raw[i] = apvts.getRawParameterValue(paramIDs[i]);
+        jassert(raw[i] != nullptr);
+
+        ramps[i].kind = kRampKinds[i];
+        ramps[i].snapTo(raw[i]->load());
+        apvts.addParameterListener(paramIDs[i], this);
+    }
+}
+
+ParameterSnapshot::~ParameterSnapshot()
+{
+    for (int i = 0; i < NUM_IDS; ++i)
+        apvts.removeParameterListener(paramIDs[i], this);
+}
+
+void ParameterSnapshot::prepare(double newSampleRate, double rampSeconds)
+{
+    sampleRate = newSampleRate;
+    rampLength = juce::jmax(0, (int)(sampleRate * rampSeconds));
+
+    // Transactions published while no blocks ran are already in the raw values.
+    const auto scope = pendingFifo.read(pendingFifo.getNumReady());
+    scope.forEach([this](int index) { release(pending[index].mask); });
+
+    for (int i = 0; i < NUM_IDS; ++i)
+        ramps[i].snapTo(raw[i]->load());
+
+    forceAll = true;
+}
+
+void ParameterSnapshot::parameterChanged(const juce::String&, float)
+{
+    version.fetch_add(1, std::memory_order_release);
+}
+
+uint32_t ParameterSnapshot::update() noexcept
+{
+    const uint32_t transacted = applyPending();
+
+    const auto v = version.load(std::memory_order_acquire);
+    if (v == seenVersion && !forceAll && transacted == 0 && released == 0) return 0;
+    seenVersion = v;
+
+    uint32_t changed = (forceAll ? range(lowG, (Id)(NUM_IDS - 1)) : 0u) | transacted;
+    forceAll = false;
+    released = 0;
+
+    for (int i = 0; i < NUM_IDS; ++i)
+    {
+        if ((overridden & bit((Id)i)) != 0) continue;
+        if (holds[i].load(std::memory_order_acquire) > 0) continue;   // mid-transaction
+
+        const float t = raw[i]->load(std::memory_order_relaxed);
+        if (t != ramps[i].target)
+        {
+            ramps[i].setTarget(t, rampLength);
+            changed |= bit((Id)i);
+        }
+    }
+    return changed;
+}
+
+bool ParameterSnapshot::isAnySmoothing(uint32_t mask) const noexcept
+{
+    for (int i = 0; i < NUM_IDS; ++i)
+        if ((mask & bit((Id)i)) != 0 && ramps[i].isSmoothing())
+            return true;
+    return false;
+}
+
+void ParameterSnapshot::skip(uint32_t mask, int numSamples) noexcept
+{
+    for (int i = 0; i < NUM_IDS; ++i)
+        if ((mask & bit((Id)i)) != 0)
+            ramps[i].skip(numSamples);
+}
+
+// ── Overrides ─────────────────────────────────────────────────────────────────
+void ParameterSnapshot::setOverrides(uint32_t mask) noexcept
+{
+    released  |= overridden & ~mask;
+    overridden = mask;
+}
+
+uint32_t ParameterSnapshot::retarget(Id id, float target) noexcept
+{
+    if (target == ramps[id].target) return 0;
+    ramps[id].setTarget(target, rampLength);
+    return bit(id);
+}
+
+// ── Transactions ──────────────────────────────────────────────────────────────
+int ParameterSnapshot::indexOf(const juce::String& paramID) noexcept
+{
+    for (int i = 0; i < NUM_IDS; ++i)
+        if (paramID == paramIDs[i]) return i;
+    return -1;
+}
+
+void ParameterSnapshot::transact(uint32_t mask, double glideSeconds, const std::function<void()>& setValues)
+{
+    const juce::ScopedLock sl(transactionLock);
+
+    for (int i = 0; i < NUM_IDS; ++i)
+        if ((mask & bit((Id)i)) != 0)
+            holds[i].fetch_add(1, std::memory_order_acq_rel);
+
+    setValues();
+
+    auto scope = pendingFifo.write(1);
+    if (scope.blockSize1 == 0)
+    {
+        release(mask);
+        version.fetch_add(1, std::memory_order_release);
+        return;
+    }
+
+    auto& p = pending[scope.startIndex1];
+    p.mask = mask;
+    p.glideSeconds = (float)glideSeconds;
+    for (int i = 0; i < NUM_IDS; ++i)
+        if ((mask & bit((Id)i)) != 0)
+            p.values[i] = raw[i]->load(std::memory_order_relaxed);
+}
+
+void ParameterSnapshot::release(uint32_t mask) noexcept
+{
+    for (int i = 0; i < NUM_IDS; ++i)
+        if ((mask & bit((Id)i)) != 0)
+            holds[i].fetch_sub(1, std::memory_order_acq_rel);
+}
+
+// Audio thread: every published transaction starts its glide in this block.
+uint32_t ParameterSnapshot::applyPending() noexcept
+{
+    const int ready = pendingFifo.getNumReady();
+    if (ready == 0) return 0;
+
+    uint32_t changed = 0;
+    const auto scope = pendingFifo.read(ready);
+    scope.forEach([this, &changed](int index) {
+        const auto& p = pending[index];
+        const int length = juce::jmax(0, (int)(p.glideSeconds * sampleRate));
+        for (int i = 0; i < NUM_IDS; ++i)
+            if ((p.mask & bit((Id)i)) != 0)
+                ramps[i].setTarget(p.values[i], length);
+        changed |= p.mask;
+        release(p.mask);
+        });
+    return changed;
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ─── Parameter snapshot ──────────────────────────────────────────────────────
+// Resolves the raw parameter atomics once and gives the audio thread a cheap
+// per-block view of them. An APVTS listener bumps a version counter on every
+// change, so a block where nothing moved costs a single atomic load.
+// Each parameter owns a ramp (linear for dB / normalised values,
+// multiplicative for Hz, Q and ratio) so automation and AI jumps glide
+// instead of zippering; stages that derive coefficients only recompute
+// while a ramp is actually moving.
+//
+// Transactions move several parameters as one: while a transaction sets its
+// values, the audio thread ignores those ids; the final values then arrive
+// through a lock-free FIFO and all start gliding in the same block.
+class ParameterSnapshot : private juce::AudioProcessorValueTreeState::Listener
+{
+public:
+    // Append only: the values double as the stable parameter ids of the
+    // binary session state (StateCodec).
+    enum Id
+    {
+        lowG, lowFreq, midG, midFreq, midQ, highG, highFreq,
+        compThresh, compRatio, compAttack, compRelease, compMakeup,
+        delayTime, delayFeedback, delayMix,
+        revDecay, revSize, revDamp, revMix,
+        aimix,
+        compKnee, compLink,
+        delaySync, delayDiv,
+        revMode,
+        osFactor, osQuality,
+        compLinkScope,
+        morph,
+        NUM_IDS
+    };
+
+    static const char* const paramIDs[NUM_IDS];
+
+    static constexpr uint32_t bit(Id id) noexcept { return 1u << (uint32_t)id; }
+    static constexpr uint32_t range(Id first, Id last) noexcept
+    {
+        return ((2u << (uint32_t)last) - 1u) & ~(bit(first) - 1u);
+    }
+
+    enum class RampKind { snap, linear, multiplicative };
+
+    struct Ramp
+    {
+        float    current = 0.f, target = 0.f, step = 0.f;
+        int      countdown = 0;
+        RampKind kind = RampKind::snap;
+
+        void  setTarget(float newTarget, int length) noexcept;
+        void  snapTo(float value) noexcept { current = target = value; countdown = 0; }
+        float next() noexcept;
+        void  skip(int numSamples) noexcept;
+        bool  isSmoothing() const noexcept { return countdown > 0; }
+    };
+
+    explicit ParameterSnapshot(juce::AudioProcessorValueTreeState& state);
+    ~ParameterSnapshot() override;
+
+    void prepare(double sampleRate, double rampSeconds = 0.02);
+
+    // Audio thread, once per block. Returns a mask of ids whose target moved
+    // (all bits on the first call after prepare()).
+    uint32_t update() noexcept;
+
+    float get(Id id) const noexcept             { return ramps[id].current; }
+    float getTarget(Id id) const noexcept       { return ramps[id].target; }
+    float getRaw(Id id) const noexcept          { return raw[id]->load(std::memory_order_relaxed); }   // any thread
+    const Ramp& getRamp(Id id) const noexcept   { return ramps[id]; }
+
+    bool isSmoothing(Id id) const noexcept      { return ramps[id].isSmoothing(); }
+    bool isAnySmoothing(uint32_t mask) const noexcept;
+
+    void skip(Id id, int numSamples) noexcept   { ramps[id].skip(numSamples); }
+    void skip(uint32_t mask, int numSamples) noexcept;
+
+    // ── Overrides ─────────────────────────────────────────────────────────
+    // Audio thread. Ids in the mask ignore their parameters and take targets
+    // from retarget() (see MorphEngine); released ids rejoin on the next
+    // update(). retarget() glides like a parameter change and returns the
+    // id's bit if the target moved.
+    void     setOverrides(uint32_t mask) noexcept;
+    uint32_t retarget(Id id, float target) noexcept;
+
+    // ── Transactions ──────────────────────────────────────────────────────
+    static int indexOf(const juce::String& paramID) noexcept;   // -1 if not tracked
+
+    // Any thread but the audio thread; transactions are serialised. Holds
+    // the ids in `mask` back from the audio thread, calls setValues() and
+    // publishes the resulting values to glide over glideSeconds. If the
+    // FIFO is full (no blocks are being processed) the values still apply,
+    // one block at a time as ordinary changes.
+    void transact(uint32_t mask, double glideSeconds, const std::function<void()>& setValues);
+
+private:
+    static constexpr int MAX_PENDING = 32;
+
+    struct Pending
+    {
+        uint32_t mask = 0;
+        float    glideSeconds = 0.f;
+        float    values[NUM_IDS] = {};
+    };
+
+    void parameterChanged(const juce::String&, float) override;
+    void release(uint32_t mask) noexcept;
+    uint32_t applyPending() noexcept;
+
+    juce::AudioProcessorValueTreeState& apvts;
+    std::atomic<float>* raw[NUM_IDS] = {};
+    Ramp ramps[NUM_IDS];
+
+    std::atomic<uint32_t> version{ 1 };
+    uint32_t seenVersion = 0;
+    bool     forceAll = true;
+    uint32_t overridden = 0, released = 0;
+    int      rampLength = 0;
+    double   sampleRate = 44100.0;
+
+    juce::CriticalSection transactionLock;        // producers only
+    juce::AbstractFifo    pendingFifo{ MAX_PENDING };
+    Pending               pending[MAX_PENDING];
+    std::atomic<int>      holds[NUM_IDS] = {};    // open transactions per id
+
+    JUCE_DECLARE_NON_COPYABLE(ParameterSnapshot)
+};
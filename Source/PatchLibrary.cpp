@@ -0,0 +1,325 @@
+#include "PatchLibrary.h"
+
+// ── Query ─────────────────────────────────────────────────────────────────────
+PatchLibrary::Query PatchLibrary::Query::parse(const juce::String& text)
+{
+    Query q;
+    juce::StringArray words;
+    for (auto& token : juce::StringArray::fromTokens(text, " \t", ""))
+    {
+        if (token.startsWithChar('#'))
+        {
+            if (token.length() > 1) q.tags.addIfNotAlreadyThere(token.substring(1).toLowerCase());
+        }
+        else if (token.isNotEmpty())
+            words.add(token);
+    }
+    q.prefix = words.joinIntoString(" ");
+    return q;
+}
+
+// ── Lifetime ──────────────────────────────────────────────────────────────────
+PatchLibrary::PatchLibrary()
+    : juce::Thread("KeroMixAI patch library")
+{
+    index = build({});
+    startThread(juce::Thread::Priority::low);
+}
+
+PatchLibrary::~PatchLibrary()
+{
+    stopThread(4000);
+}
+
+juce::File PatchLibrary::getDirectory()
+{
+    auto dir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                   .getChildFile("KeroMixAI")
+                   .getChildFile("Patches");
+    dir.createDirectory();
+    return dir;
+}
+
+juce::File PatchLibrary::getIndexFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("KeroMixAI").getChildFile("patch_index.bin");
+}
+
+// ── Lookup ────────────────────────────────────────────────────────────────────
+PatchLibrary::IndexPtr PatchLibrary::getIndex() const
+{
+    const juce::ScopedLock sl(lock);
+    return index;
+}
+
+PatchLibrary::PatchPtr PatchLibrary::find(const juce::String& name) const
+{
+    const auto idx = getIndex();
+    const auto key = name.toLowerCase();
+    const auto it  = std::lower_bound(idx->keys.begin(), idx->keys.end(), key);
+    if (it == idx->keys.end() || *it != key) return nullptr;
+    return idx->patches[(size_t)(it - idx->keys.begin())];
+}
+
+int PatchLibrary::getNumPatches() const
+{
+    return (int)getIndex()->patches.size();
+}
+
+// The name prefix is a range of the sorted keys; each tag (itself a prefix,
+// so "#wa" finds "warm") narrows that range through the tag lists.
+juce::StringArray PatchLibrary::search(const Query& query) const
+{
+    const auto idx    = getIndex();
+    const auto& keys  = idx->keys;
+    const auto prefix = query.prefix.toLowerCase();
+
+    const int lo = (int)(std::lower_bound(keys.begin(), keys.end(), prefix) - keys.begin());
+    int hi = lo;
+    while (hi < (int)keys.size() && keys[(size_t)hi].startsWith(prefix)) ++hi;
+
+    juce::StringArray names;
+    if (query.tags.isEmpty())
+    {
+        names.ensureStorageAllocated(hi - lo);
+        for (int i = lo; i < hi; ++i) names.add(idx->patches[(size_t)i]->name);
+        return names;
+    }
+
+    std::vector<int> candidates;
+    for (int t = 0; t < query.tags.size(); ++t)
+    {
+        std::vector<int> matching;
+        for (auto it = idx->byTag.lower_bound(query.tags[t]);
+             it != idx->byTag.end() && it->first.startsWith(query.tags[t]); ++it)
+            matching.insert(matching.end(), it->second.begin(), it->second.end());
+        std::sort(matching.begin(), matching.end());
+        matching.erase(std::unique(matching.begin(), matching.end()), matching.end());
+
+        if (t == 0)
+            candidates = std::move(matching);
+        else
+        {
+            std::vector<int> both;
+            std::set_intersection(candidates.begin(), candidates.end(), matching.begin(), matching.end(),
+                                  std::back_inserter(both));
+            candidates = std::move(both);
+        }
+        if (candidates.empty()) return names;
+    }
+
+    for (auto i : candidates)
+        if (i >= lo && i < hi) names.add(idx->patches[(size_t)i]->name);
+    return names;
+}
+
+// ── Parsing ───────────────────────────────────────────────────────────────────
+PatchLibrary::PatchPtr PatchLibrary::parse(const juce::File& file)
+{
+    auto xml = juce::XmlDocument::parse(file);
+    if (xml == nullptr) return nullptr;
+
+    StateCodec::State state;
+    StateCodec::fromXml(*xml, state);
+
+    auto p = std::make_shared<Patch>();
+    p->name     = file.getFileNameWithoutExtension();
+    p->irPath   = state.irPath;
+    p->modified = file.getLastModificationTime().toMilliseconds();
+    p->size     = file.getSize();
+
+    p->tags = juce::StringArray::fromTokens(xml->getStringAttribute("tags").toLowerCase(), ",", "");
+    p->tags.trim();
+    p->tags.removeEmptyStrings();
+
+    std::copy(std::begin(state.values), std::end(state.values), std::begin(p->values));
+    return p;
+}
+
+PatchLibrary::IndexPtr PatchLibrary::build(std::vector<PatchPtr> patches)
+{
+    std::vector<std::pair<juce::String, PatchPtr>> sorted;
+    sorted.reserve(patches.size());
+    for (auto& p : patches) sorted.emplace_back(p->name.toLowerCase(), std::move(p));
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    auto idx = std::make_shared<Index>();
+    idx->patches.reserve(sorted.size());
+    idx->keys.reserve(sorted.size());
+    for (auto& [key, p] : sorted)
+    {
+        for (auto& tag : p->tags) idx->byTag[tag].push_back((int)idx->patches.size());
+        idx->keys.push_back(std::move(key));
+        idx->patches.push_back(std::move(p));
+    }
+    return idx;
+}
+
+// ── Updates ───────────────────────────────────────────────────────────────────
+void PatchLibrary::patchSaved(const juce::File& file)
+{
+    replace(file.getFileNameWithoutExtension(), parse(file));
+}
+
+void PatchLibrary::patchDeleted(const juce::String& name)
+{
+    replace(name, nullptr);
+}
+
+void PatchLibrary::replace(const juce::String& name, PatchPtr patch)
+{
+    {
+        const juce::ScopedLock sl(lock);
+        std::vector<PatchPtr> patches;
+        patches.reserve(index->patches.size() + 1);
+        for (auto& p : index->patches)
+            if (p->name != name) patches.push_back(p);
+        if (patch != nullptr) patches.push_back(std::move(patch));
+        index = build(std::move(patches));
+    }
+    indexDirty = true;
+    sendChangeMessage();
+}
+
+// Only swaps in `patches` if nobody published since `basis` was taken;
+// otherwise the next poll starts again from the newer index.
+bool PatchLibrary::publish(std::vector<PatchPtr> patches, const IndexPtr& basis)
+{
+    auto next = build(std::move(patches));
+    {
+        const juce::ScopedLock sl(lock);
+        if (index != basis) return false;
+        index = std::move(next);
+    }
+    indexDirty = true;
+    sendChangeMessage();
+    return true;
+}
+
+// ── Scanning ──────────────────────────────────────────────────────────────────
+void PatchLibrary::run()
+{
+    readIndexFile();
+
+    while (!threadShouldExit())
+    {
+        scan();
+        if (indexDirty.exchange(false)) writeIndexFile(*getIndex());
+        wait(POLL_MS);
+    }
+}
+
+// Directory entries carry size and modification time, so an unchanged
+// library costs one directory listing per poll.
+void PatchLibrary::scan()
+{
+    const auto basis = getIndex();
+
+    std::map<juce::String, PatchPtr> known;
+    for (auto& p : basis->patches) known.emplace(p->name, p);
+
+    std::vector<PatchPtr> patches;
+    patches.reserve(basis->patches.size());
+    bool changed = false;
+
+    for (const auto& entry : juce::RangedDirectoryIterator(getDirectory(), false, "*.xml", juce::File::findFiles))
+    {
+        if (threadShouldExit()) return;
+
+        const auto file     = entry.getFile();
+        const auto name     = file.getFileNameWithoutExtension();
+        const auto modified = entry.getModificationTime().toMilliseconds();
+        const auto size     = entry.getFileSize();
+
+        const auto it = known.find(name);
+        if (it != known.end())
+        {
+            auto p = std::move(it->second);
+            known.erase(it);
+            if (p->modified == modified && p->size == size)
+            {
+                patches.push_back(std::move(p));
+                continue;
+            }
+        }
+
+        const auto bad = unreadable.find(name);
+        if (bad != unreadable.end() && bad->second == modified) continue;
+
+        changed = true;
+        if (auto p = parse(file))
+        {
+            unreadable.erase(name);
+            patches.push_back(std::move(p));
+        }
+        else
+            unreadable[name] = modified;
+    }
+
+    if (changed || !known.empty())
+        publish(std::move(patches), basis);
+}
+
+// ── Index file ────────────────────────────────────────────────────────────────
+// Header, then per patch: name, tags, IR path, modification time, size and
+// NUM_IDS floats. Any mismatch discards the file; the scan rebuilds it.
+bool PatchLibrary::readIndexFile()
+{
+    juce::MemoryBlock data;
+    if (!getIndexFile().loadFileAsData(data)) return false;
+
+    juce::MemoryInputStream in(data, false);
+    if ((uint32_t)in.readInt() != MAGIC || (uint32_t)in.readInt() != VERSION
+        || in.readInt() != ParameterSnapshot::NUM_IDS)
+        return false;
+
+    const int count = in.readInt();
+    if (count < 0) return false;
+
+    std::vector<PatchPtr> patches;
+    patches.reserve((size_t)count);
+    for (int n = 0; n < count; ++n)
+    {
+        if (in.isExhausted()) return false;
+
+        auto p = std::make_shared<Patch>();
+        p->name     = in.readString();
+        p->tags     = juce::StringArray::fromTokens(in.readString(), ",", "");
+        p->irPath   = in.readString();
+        p->modified = in.readInt64();
+        p->size     = in.readInt64();
+        for (auto& v : p->values) v = in.readFloat();
+        p->tags.removeEmptyStrings();
+        patches.push_back(std::move(p));
+    }
+    if (in.getPosition() != in.getTotalLength()) return false;
+
+    const bool published = publish(std::move(patches), getIndex());
+    indexDirty = false;   // it came from the file
+    return published;
+}
+
+void PatchLibrary::writeIndexFile(const Index& idx) const
+{
+    juce::MemoryOutputStream out;
+    out.writeInt((int)MAGIC);
+    out.writeInt((int)VERSION);
+    out.writeInt(ParameterSnapshot::NUM_IDS);
+    out.writeInt((int)idx.patches.size());
+    for (auto& p : idx.patches)
+    {
+        out.writeString(p->name);
+        out.writeString(p->tags.joinIntoString(","));
+        out.writeString(p->irPath);
+        out.writeInt64(p->modified);
+        out.writeInt64(p->size);
+        for (auto v : p->values) out.writeFloat(v);
+    }
+
+    const auto file = getIndexFile();
+    file.getParentDirectory().createDirectory();
+    juce::TemporaryFile temp(file);
+    if (temp.getFile().replaceWithData(out.getData(), out.getDataSize()))
+        temp.overwriteTargetFileWithTemporary();
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <JuceHeader.h>
+#include "ParameterSnapshot.h"
+#include "StateCodec.h"
+
+// ─── Patch library ───────────────────────────────────────────────────────────
+// In-memory index of the patch directory, shared by every instance in the
+// process (hold it through a juce::SharedResourcePointer). A low-priority
+// thread polls the directory every POLL_MS and re-parses only files whose
+// size or modification time changed, so the message thread never lists or
+// parses patches itself.
+//
+// Every patch is kept fully parsed (plain values in ParameterSnapshot order
+// plus the IR path), so loading one is a lookup and a parameter
+// transaction. The index is also written to patch_index.bin, so a new
+// session lists thousands of patches before the first scan finishes.
+//
+// Readers take an immutable snapshot; a scan builds a new one and swaps it
+// in, then sends a change message to listeners on the message thread.
+// Search text is a name prefix plus optional #tags: "bass #warm #live".
+class PatchLibrary : public juce::ChangeBroadcaster,
+                     private juce::Thread
+{
+public:
+    static constexpr int POLL_MS = 2000;
+
+    struct Patch
+    {
+        juce::String      name;              // file name without extension
+        juce::StringArray tags;              // lower case
+        juce::String      irPath;
+        juce::int64       modified = 0, size = 0;
+        float             values[ParameterSnapshot::NUM_IDS];   // NaN = not stored
+
+        bool hasValue(int i) const noexcept { return !std::isnan(values[i]); }
+    };
+    using PatchPtr = std::shared_ptr<const Patch>;
+
+    struct Query
+    {
+        juce::String      prefix;            // as typed; matched ignoring case
+        juce::StringArray tags;              // lower case
+
+        static Query parse(const juce::String& text);
+        bool isEmpty() const noexcept { return prefix.isEmpty() && tags.isEmpty(); }
+    };
+
+    PatchLibrary();
+    ~PatchLibrary() override;
+
+    static juce::File getDirectory();
+
+    // Any thread.
+    PatchPtr          find(const juce::String& name) const;
+    juce::StringArray search(const Query& query) const;   // sorted by name
+    int               getNumPatches() const;
+
+    // Message thread, after the processor wrote or removed a file. The
+    // change shows up at once instead of on the next poll.
+    void patchSaved(const juce::File& file);
+    void patchDeleted(const juce::String& name);
+
+    static PatchPtr parse(const juce::File& file);
+
+private:
+    struct Index
+    {
+        std::vector<PatchPtr>     patches;   // sorted by lower-case name
+        std::vector<juce::String> keys;      // lower-case names, same order
+        std::map<juce::String, std::vector<int>> byTag;   // ascending positions
+    };
+    using IndexPtr = std::shared_ptr<const Index>;
+
+    static constexpr uint32_t MAGIC   = 0x314c504b;   // "KPL1"
+    static constexpr uint32_t VERSION = 1;
+
+    void     run() override;
+    void     scan();
+    IndexPtr getIndex() const;
+    bool     publish(std::vector<PatchPtr> patches, const IndexPtr& basis);
+    void     replace(const juce::String& name, PatchPtr patch);
+
+    static IndexPtr   build(std::vector<PatchPtr> patches);
+    static juce::File getIndexFile();
+    bool              readIndexFile();
+    void              writeIndexFile(const Index& idx) const;
+
+    mutable juce::CriticalSection lock;      // guards `index`
+    IndexPtr          index;
+    std::atomic<bool> indexDirty{ false };   // patch_index.bin is behind
+
+    std::map<juce::String, juce::int64> unreadable;   // scan thread: name, mtime
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatchLibrary)
+};
@@ -23,8 +23,9 @@ const int KeroMixAIAudioProcessorEditor::PARAM_GROUP[NUM_PARAMS] =
 
 // ── Constructor ───────────────────────────────────────────────────────────────
 KeroMixAIAudioProcessorEditor::KeroMixAIAudioProcessorEditor(KeroMixAIAudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p), juce::Thread("GroqThread")
+    : AudioProcessorEditor(&p), audioProcessor(p)
 {
+    setOpaque(true);
     setSize(900, 540);
 
     // Sliders
@@ -79,6 +80,26 @@ KeroMixAIAudioProcessorEditor::KeroMixAIAudioProcessorEditor(KeroMixAIAudioProce
         addAndMakeVisible(btn);
     }
 
+    // Convolution reverb
+    irModeBtn.setButtonText("Convolution");
+    irModeBtn.setColour(juce::ToggleButton::textColourId, kLabel);
+    irModeBtn.setColour(juce::ToggleButton::tickColourId, kGreen);
+    addAndMakeVisible(irModeBtn);
+    irModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.apvts, "revMode", irModeBtn);
+
+    irLoadBtn.setButtonText("IR...");
+    irLoadBtn.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff4a90d9));
+    irLoadBtn.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+    irLoadBtn.onClick = [this]() { chooseImpulseResponse(); };
+    addAndMakeVisible(irLoadBtn);
+
+    irNameLabel.setFont(juce::Font(10.f));
+    irNameLabel.setColour(juce::Label::textColourId, juce::Colour(0xff888888));
+    irNameLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(irNameLabel);
+    refreshImpulseResponseName();
+
     // Prompt
     promptInput.setMultiLine(false);
     promptInput.setReturnKeyStartsNewLine(false);
@@ -103,6 +124,15 @@ KeroMixAIAudioProcessorEditor::KeroMixAIAudioProcessorEditor(KeroMixAIAudioProce
     undoBtn.onClick = [this]() { restoreSnapshot(); };
     addAndMakeVisible(undoBtn);
 
+    morphSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    morphSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    morphSlider.setColour(juce::Slider::trackColourId, kKero);
+    morphSlider.setColour(juce::Slider::thumbColourId, kGreen);
+    morphAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "morph", morphSlider);
+    addChildComponent(morphSlider);
+    morphSlider.setVisible(audioProcessor.getNumMorphStates() >= 2);
+
     statusLabel.setText("", juce::dontSendNotification);
     statusLabel.setFont(juce::Font(10.5f));
     statusLabel.setColour(juce::Label::textColourId, juce::Colour(0xff888888));
@@ -126,22 +156,31 @@ KeroMixAIAudioProcessorEditor::KeroMixAIAudioProcessorEditor(KeroMixAIAudioProce
     settingsBtn.onClick = [this]() { showSettings(); };
     addAndMakeVisible(settingsBtn);
 
+   #if KEROMIX_DSP_LOAD
+    dspLoadBtn.setButtonText("DSP");
+    dspLoadBtn.setColour(juce::TextButton::buttonColourId, juce::Colour(0xffeeeeee));
+    dspLoadBtn.setColour(juce::TextButton::textColourOffId, juce::Colour(0xff666666));
+    dspLoadBtn.onClick = [this]() { toggleDspLoad(); };
+    addAndMakeVisible(dspLoadBtn);
+   #endif
+
     // Patch UI
     patchNameInput.setTextToShowWhenEmpty("Patch name...", juce::Colour(0xffaaaaaa));
     patchNameInput.setFont(juce::Font(11.f));
     patchNameInput.setColour(juce::TextEditor::backgroundColourId, juce::Colours::white);
     patchNameInput.setColour(juce::TextEditor::outlineColourId, juce::Colour(0xffdddddd));
     patchNameInput.setColour(juce::TextEditor::textColourId, juce::Colour(0xff333333));
+    patchNameInput.onTextChange = [this]() { refreshPatchList(); };
     addAndMakeVisible(patchNameInput);
 
     saveBtn.setButtonText("Save");
     saveBtn.setColour(juce::TextButton::buttonColourId, kKero);
     saveBtn.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
     saveBtn.onClick = [this]() {
-        auto name = patchNameInput.getText().trim();
+        const auto entry = PatchLibrary::Query::parse(patchNameInput.getText());
+        const auto name  = entry.prefix;
         if (name.isEmpty()) { statusLabel.setText("Enter patch name!", juce::dontSendNotification); return; }
-        audioProcessor.savePatch(name);
-        refreshPatchList();
+        audioProcessor.savePatch(name, entry.tags);
         statusLabel.setText("Saved: " + name, juce::dontSendNotification);
         };
     addAndMakeVisible(saveBtn);
@@ -153,6 +192,8 @@ KeroMixAIAudioProcessorEditor::KeroMixAIAudioProcessorEditor(KeroMixAIAudioProce
         auto name = patchList.getText();
         if (name.isEmpty()) return;
         audioProcessor.loadPatch(name);
+        endBeforeAfter();
+        refreshImpulseResponseName();
         statusLabel.setText("Loaded: " + name, juce::dontSendNotification);
         };
     addAndMakeVisible(loadBtn);
@@ -164,7 +205,6 @@ KeroMixAIAudioProcessorEditor::KeroMixAIAudioProcessorEditor(KeroMixAIAudioProce
         auto name = patchList.getText();
         if (name.isEmpty()) return;
         audioProcessor.deletePatch(name);
-        refreshPatchList();
         statusLabel.setText("Deleted: " + name, juce::dontSendNotification);
         };
     addAndMakeVisible(deleteBtn);
@@ -173,32 +213,50 @@ KeroMixAIAudioProcessorEditor::KeroMixAIAudioProcessorEditor(KeroMixAIAudioProce
     patchList.setColour(juce::ComboBox::backgroundColourId, juce::Colours::white);
     patchList.setColour(juce::ComboBox::outlineColourId, juce::Colour(0xffdddddd));
     addAndMakeVisible(patchList);
+    patchLibrary->addChangeListener(this);
     refreshPatchList();
 
     groqApiKey = loadApiKey();
-    if (groqApiKey.isEmpty()) showSettings();
+    aiEndpoint = loadEndpoint();
+    if (needsApiKey()) showSettings();
 
+    audioProcessor.analysis.addClient();
     startTimerHz(30);
 }
 
 KeroMixAIAudioProcessorEditor::~KeroMixAIAudioProcessorEditor()
 {
     stopTimer();
-    stopThread(2000);
+    patchLibrary->removeChangeListener(this);
+    aiScheduler->cancel(this);
+    audioProcessor.analysis.removeClient();
 }
 
 // ── Settings panel ────────────────────────────────────────────────────────────
+juce::Rectangle<int> KeroMixAIAudioProcessorEditor::getSettingsBounds() const
+{
+    return { getWidth() - SettingsComponent::WIDTH - 10, 40, SettingsComponent::WIDTH, SettingsComponent::HEIGHT };
+}
+
 void KeroMixAIAudioProcessorEditor::showSettings()
 {
     settingsPanel = std::make_unique<SettingsComponent>();
-    settingsPanel->setBounds(getWidth() - 280, 40, 270, 170);
-    settingsPanel->onKeyEntered = [this](const juce::String& key) {
-        groqApiKey = key;
-        saveApiKey(key);
+    settingsPanel->setBounds(getSettingsBounds());
+    settingsPanel->setEndpoint(aiEndpoint);
+    settingsPanel->onSave = [this](const juce::String& key, const juce::String& endpoint) {
+        if (key.isNotEmpty())
+        {
+            groqApiKey = key;
+            saveApiKey(key);
+        }
+        aiEndpoint = endpoint;
+        saveEndpoint(endpoint);
         hideSettings();
-        statusLabel.setText("API key saved!", juce::dontSendNotification);
+        statusLabel.setText("Settings saved!", juce::dontSendNotification);
         };
     settingsPanel->onClose = [this]() { hideSettings(); };
+    settingsPanel->onClearCache = [this]() { responseCache->clear(); refreshCacheStats(); };
+    refreshCacheStats();
     addAndMakeVisible(*settingsPanel);
     settingsPanel->toFront(true);
 }
@@ -208,13 +266,69 @@ void KeroMixAIAudioProcessorEditor::hideSettings()
     if (settingsPanel) { removeChildComponent(settingsPanel.get()); settingsPanel.reset(); }
 }
 
+void KeroMixAIAudioProcessorEditor::refreshCacheStats()
+{
+    if (!settingsPanel) return;
+    const auto st = responseCache->getStats();
+    const auto lookups = st.hits + st.misses;
+    settingsPanel->setCacheStats("Cache: " + juce::String(st.entries) + "/" + juce::String(st.capacity)
+        + " entries, " + juce::String((juce::int64)st.hits) + " hits / " + juce::String((juce::int64)lookups)
+        + " (" + juce::String(lookups > 0 ? (int)(100 * st.hits / lookups) : 0) + "%)");
+}
+
+#if KEROMIX_DSP_LOAD
+// ── DSP load panel ────────────────────────────────────────────────────────────
+void KeroMixAIAudioProcessorEditor::toggleDspLoad()
+{
+    if (dspLoadPanel)
+    {
+        removeChildComponent(dspLoadPanel.get());
+        dspLoadPanel.reset();
+        return;
+    }
+    dspLoadPanel = std::make_unique<DspLoadPanel>(audioProcessor.dspLoad);
+    dspLoadPanel->setBounds(getWidth() - 330, 40, 320, 160);
+    dspLoadPanel->onClose = [this]() { toggleDspLoad(); };
+    addAndMakeVisible(*dspLoadPanel);
+    dspLoadPanel->toFront(false);
+}
+#endif
+
 // ── Patch ─────────────────────────────────────────────────────────────────────
 void KeroMixAIAudioProcessorEditor::refreshPatchList()
 {
-    patchList.clear();
-    auto names = audioProcessor.getSavedPatchNames();
+    const auto selected = patchList.getText();
+    const auto names = patchLibrary->search(PatchLibrary::Query::parse(patchNameInput.getText()));
+
+    patchList.clear(juce::dontSendNotification);
     for (int i = 0; i < names.size(); ++i)
         patchList.addItem(names[i], i + 1);
+
+    const int keep = names.indexOf(selected);
+    if (keep >= 0) patchList.setSelectedItemIndex(keep, juce::dontSendNotification);
+}
+
+// ── Impulse response ──────────────────────────────────────────────────────────
+void KeroMixAIAudioProcessorEditor::chooseImpulseResponse()
+{
+    irChooser = std::make_unique<juce::FileChooser>("Load impulse response",
+        audioProcessor.getImpulseResponseFile(), "*.wav;*.aif;*.aiff");
+
+    irChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+        [this](const juce::FileChooser& fc) {
+            auto f = fc.getResult();
+            if (f == juce::File()) return;
+            if (!audioProcessor.loadImpulseResponse(f))
+                statusLabel.setText("Could not read IR: " + f.getFileName(), juce::dontSendNotification);
+            refreshImpulseResponseName();
+            });
+}
+
+void KeroMixAIAudioProcessorEditor::refreshImpulseResponseName()
+{
+    auto f = audioProcessor.getImpulseResponseFile();
+    irNameLabel.setText(f == juce::File() ? "No IR loaded" : f.getFileNameWithoutExtension(),
+        juce::dontSendNotification);
 }
 
 // ── Undo ──────────────────────────────────────────────────────────────────────
@@ -222,6 +336,7 @@ void KeroMixAIAudioProcessorEditor::saveSnapshot()
 {
     for (int i = 0; i < NUM_PARAMS; ++i)
         undoSnapshot[i] = (float)*audioProcessor.apvts.getRawParameterValue(paramIDs[i]);
+    morphBefore = audioProcessor.captureState();
     hasUndoSnapshot = true;
     undoBtn.setEnabled(true);
 }
@@ -229,15 +344,35 @@ void KeroMixAIAudioProcessorEditor::saveSnapshot()
 void KeroMixAIAudioProcessorEditor::restoreSnapshot()
 {
     if (!hasUndoSnapshot) return;
+    endBeforeAfter();
+    KeroMixAIAudioProcessor::ParameterTransaction t;
     for (int i = 0; i < NUM_PARAMS; ++i)
-        if (auto* param = audioProcessor.apvts.getParameter(paramIDs[i]))
-            param->setValueNotifyingHost(
-                audioProcessor.apvts.getParameterRange(paramIDs[i]).convertTo0to1(undoSnapshot[i]));
+        t.set(paramIDs[i], undoSnapshot[i]);
+    audioProcessor.applyTransaction(t);
     undoBtn.setEnabled(false);
     hasUndoSnapshot = false;
     statusLabel.setText("Reverted.", juce::dontSendNotification);
 }
 
+// "morph" moves to the after end before the states arrive, so nothing jumps.
+void KeroMixAIAudioProcessorEditor::offerBeforeAfter()
+{
+    KeroMixAIAudioProcessor::ParameterTransaction t;
+    t.set("morph", 1.f);
+    audioProcessor.applyTransaction(t);
+    audioProcessor.setMorphStates({ morphBefore, audioProcessor.captureState() });
+
+    morphSlider.setVisible(audioProcessor.getNumMorphStates() >= 2);
+    resized();
+}
+
+void KeroMixAIAudioProcessorEditor::endBeforeAfter()
+{
+    audioProcessor.clearMorph();
+    morphSlider.setVisible(false);
+    resized();
+}
+
 // ── API key ───────────────────────────────────────────────────────────────────
 void KeroMixAIAudioProcessorEditor::saveApiKey(const juce::String& key)
 {
@@ -254,93 +389,230 @@ juce::String KeroMixAIAudioProcessorEditor::loadApiKey()
     return f.existsAsFile() ? f.loadFileAsString().trim() : juce::String();
 }
 
-// ── FFT ───────────────────────────────────────────────────────────────────────
-void KeroMixAIAudioProcessorEditor::processFFT()
+void KeroMixAIAudioProcessorEditor::saveEndpoint(const juce::String& url)
 {
-    fftWindow.multiplyWithWindowingTable(fftData, FFT_SIZE);
-    fft.performFrequencyOnlyForwardTransform(fftData);
+    auto f = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("KeroMixAI").getChildFile("endpoint.txt");
+    if (url.isEmpty()) { f.deleteFile(); return; }
+    f.getParentDirectory().createDirectory();
+    f.replaceWithText(url);
+}
 
-    const double sr = audioProcessor.getSampleRate();
-    if (sr <= 0.0) return;
-    const int    bins = FFT_SIZE / 2;
-    const double bw = sr / FFT_SIZE;
+juce::String KeroMixAIAudioProcessorEditor::loadEndpoint()
+{
+    auto f = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("KeroMixAI").getChildFile("endpoint.txt");
+    return f.existsAsFile() ? f.loadFileAsString().trim() : juce::String();
+}
 
-    auto toDb = [&](int s, int e) -> float {
-        float sum = 0.f; int n = 0;
-        for (int i = s; i < e && i < bins; ++i) { sum += fftData[i] * fftData[i]; ++n; }
-        if (!n) return -60.f;
-        return juce::jmax(-60.f, juce::Decibels::gainToDecibels(std::sqrt(sum / n) / FFT_SIZE));
-        };
+bool KeroMixAIAudioProcessorEditor::isLocalEndpoint() const
+{
+    const auto host = juce::URL(getEndpoint()).getDomain();
+    return host == "localhost" || host == "127.0.0.1";
+}
 
-    int lEnd = (int)(300.0 / bw), mEnd = (int)(4000.0 / bw), hEnd = (int)(20000.0 / bw);
-    const float a = 0.15f;
-    specLow += a * (toDb(1, lEnd) - specLow);
-    specMid += a * (toDb(lEnd, mEnd) - specMid);
-    specHigh += a * (toDb(mEnd, hEnd) - specHigh);
-    fftDataReady = false;
+void KeroMixAIAudioProcessorEditor::setAiEndpoint(const juce::String& url, const juce::String& apiKey)
+{
+    aiEndpoint = url;
+    groqApiKey = apiKey;
 }
 
+// ── Spectrum ──────────────────────────────────────────────────────────────────
 void KeroMixAIAudioProcessorEditor::timerCallback()
 {
+    const auto snap = audioProcessor.analysis.getSnapshot();
+    if (snap->frames == specFrames) return;
+    specFrames = snap->frames;
+
+    // Only bars whose height moved by a visible amount are repainted.
+    for (int i = 0; i < 3; ++i)
     {
-        juce::ScopedLock sl(audioProcessor.fftLock);
-        if (audioProcessor.fftDataReady)
+        const float dB   = juce::jmax(-60.f, snap->regionLevelDb[i]);
+        const int   step = juce::roundToInt((dB + 60.f) * 4.f);
+        specLevels[i] = dB;
+        if (step != specSteps[i])
         {
-            juce::zeromem(fftData, sizeof(fftData));
-            memcpy(fftData, audioProcessor.fftFifo, sizeof(float) * FFT_SIZE);
-            audioProcessor.fftDataReady = false;
-            fftDataReady = true;
+            specSteps[i] = step;
+            repaint(specBars[i].getSmallestIntegerContainer());
         }
     }
-    if (fftDataReady) processFFT();
-    repaint();
 }
 
 // ── Groq ──────────────────────────────────────────────────────────────────────
 void KeroMixAIAudioProcessorEditor::sendToGroq(const juce::String& prompt)
 {
     if (prompt.trim().isEmpty()) return;
-    if (groqApiKey.isEmpty()) { showSettings(); return; }
 
-    saveSnapshot();
-
-    juce::String lockedList, currentParams = "{";
+    juce::String lockedList;
+    JsonWriter   json(1024);
+    json.beginObject();
     for (int i = 0; i < NUM_PARAMS; ++i)
     {
-        if (i > 0) currentParams << ",";
-        currentParams << "\"" << paramIDs[i] << "\":"
-            << (float)*audioProcessor.apvts.getRawParameterValue(paramIDs[i]);
+        json.key(paramIDs[i].toRawUTF8()).value((double)*audioProcessor.apvts.getRawParameterValue(paramIDs[i]));
         if (isParamInLockedGroup(i))
             lockedList += (lockedList.isEmpty() ? "" : ",") + paramIDs[i];
     }
-    currentParams << "}";
+    json.endObject();
+    const auto currentParams = juce::String::fromUTF8(json.getData(), (int)json.getSize());
+
+    // Long-term averages describe the mix better than the meter ballistics.
+    using AE = AnalysisEngine;
+    const auto snap = audioProcessor.analysis.getSnapshot();
+    auto avg = [&](AE::Region r) { return juce::String(juce::jmax(-60.f, snap->regionAverageDb[r]), 1); };
 
     juce::String spec;
-    spec << "Low:" << juce::String(specLow, 1) << "dB Mid:" << juce::String(specMid, 1)
-        << "dB High:" << juce::String(specHigh, 1) << "dB";
+    spec << "Low:" << avg(AE::regionLow) << "dB Mid:" << avg(AE::regionMid)
+        << "dB High:" << avg(AE::regionHigh) << "dB";
+
+    const juce::String userEntry = "Params:" + currentParams + " Request:" + prompt;
 
+    // Plain requests ("Warmer", "less reverb") are handled without the network.
+    std::vector<IntentEngine::Param> params;
+    for (int i = 0; i < NUM_PARAMS; ++i)
+        params.push_back({ paramIDs[i], (float)*audioProcessor.apvts.getRawParameterValue(paramIDs[i]),
+                           audioProcessor.apvts.getParameterRange(paramIDs[i]), isParamInLockedGroup(i) });
+
+    const auto intent = IntentEngine::interpret(prompt, params,
+                                                juce::jmax(-60.f, snap->regionAverageDb[AE::regionLow]),
+                                                juce::jmax(-60.f, snap->regionAverageDb[AE::regionMid]),
+                                                juce::jmax(-60.f, snap->regionAverageDb[AE::regionHigh]));
+    if (intent.isRecognised())
     {
-        juce::ScopedLock sl(threadLock);
-        pendingPrompt = prompt + "|||" + currentParams + "|||" + lockedList + "|||" + spec;
+        std::vector<std::pair<int, float>> targets;
+        for (auto& c : intent.changes)
+            targets.push_back({ paramLookup.find(c.id), c.value });
+        applyLocally(targets, userEntry, "Applied locally: " + intent.intents.joinIntoString(", "));
+        return;
     }
 
+    // Repeat requests in (nearly) the same situation are answered locally.
+    float    normalised[NUM_PARAMS];
+    uint32_t lockedMask = 0;
+    for (int i = 0; i < NUM_PARAMS; ++i)
+    {
+        auto* param = audioProcessor.apvts.getParameter(paramIDs[i]);
+        normalised[i] = param != nullptr ? param->getValue() : 0.f;
+    }
+    for (int g = 0; g < NUM_GROUPS; ++g)
+        if (locked[g]) lockedMask |= 1u << g;
+
+    float spectrum[AE::NUM_REGIONS];
+    for (int r = 0; r < AE::NUM_REGIONS; ++r)
+        spectrum[r] = juce::jmax(-60.f, snap->regionAverageDb[r]);
+
+    const auto cacheKey = ResponseCache::makeKey(prompt, normalised, NUM_PARAMS, lockedMask, spectrum, AE::NUM_REGIONS);
+    std::vector<ResponseCache::Delta> cached;
+    if (cacheEnabled && responseCache->lookup(cacheKey, cached))
+    {
+        std::vector<std::pair<int, float>> targets;
+        for (auto& d : cached)
+            if (juce::isPositiveAndBelow(d.index, NUM_PARAMS))
+                targets.push_back({ d.index, (float)*audioProcessor.apvts.getRawParameterValue(paramIDs[d.index]) + d.amount });
+        applyLocally(targets, userEntry, "AI applied from cache!");
+        return;
+    }
+
+    if (needsApiKey())
+    {
+        statusLabel.setText("Offline: try warmer, brighter, punch, reverb, less mud...", juce::dontSendNotification);
+        showSettings();
+        promptFinished();
+        return;
+    }
+
+    // Callbacks run after the scheduler's worker; they only reach the editor
+    // through a SafePointer, and only while this is still the latest request.
+    const int id = ++aiRequestId;
+    juce::Component::SafePointer<KeroMixAIAudioProcessorEditor> safe(this);
+
+    // Parameters are applied one by one as the model streams them out.
+    auto stream = std::make_shared<LlmStream>();
+    stream->onParameter = [safe, id](const juce::String& key, float value) {
+        juce::MessageManager::callAsync([safe, id, key, value]() {
+            if (safe != nullptr && safe->aiRequestId == id) safe->applyStreamedParam(key, value);
+            });
+        };
+
+    AiScheduler::Request request;
+    request.owner   = this;
+    request.url     = juce::URL(getEndpoint()).withPOSTData(buildRequestBody(prompt, currentParams, lockedList, spec));
+    request.headers = "Content-Type: application/json";
+    if (groqApiKey.isNotEmpty())
+        request.headers << "\r\nAuthorization: Bearer " << groqApiKey;
+    request.rateLimited = !isLocalEndpoint();
+    request.onResponse = [stream](juce::InputStream& in, const AiScheduler::StopCheck& shouldStop) {
+        stream->read(in, shouldStop);
+        };
+    request.onFinished = [safe, id, stream, userEntry](AiScheduler::Status status, int) {
+        // Servers that ignore "stream" answer with a single JSON body.
+        const bool   streamed = stream->hasEvents();
+        juce::String resp = stream->getRaw();
+        juce::String pj = streamed ? stream->getObject() : extractParamsJson(resp);
+        juce::MessageManager::callAsync([safe, id, status, streamed, pj, resp, userEntry]() {
+            if (safe != nullptr && safe->aiRequestId == id)
+                safe->finishAiRequest(status, streamed, pj, resp, userEntry);
+            });
+        };
+
+    // A request that replaces one still in flight keeps its undo point.
+    const bool wasBusy = aiBusy;
+    if (!aiScheduler->submit(std::move(request)))
+    {
+        statusLabel.setText("AI busy, try again.", juce::dontSendNotification);
+        promptFinished();
+        return;
+    }
+    if (!wasBusy) saveSnapshot();
+
+    aiBusy = true;
+    aiApplied = 0;
+    aiCacheKey = cacheKey;
+    for (int i = 0; i < NUM_PARAMS; ++i)
+        aiRequestValues[i] = (float)*audioProcessor.apvts.getRawParameterValue(paramIDs[i]);
     statusLabel.setText("Processing...", juce::dontSendNotification);
-    sendBtn.setEnabled(false);
-    for (int i = 0; i < NUM_QUICK; ++i) quickBtns[i].setEnabled(false);
-    if (!isThreadRunning()) startThread();
+    refreshCacheStats();
 }
 
-void KeroMixAIAudioProcessorEditor::run()
+void KeroMixAIAudioProcessorEditor::applyLocally(const std::vector<std::pair<int, float>>& targets,
+                                                 const juce::String& userEntry, const juce::String& source)
 {
-    juce::String full;
-    { juce::ScopedLock sl(threadLock); full = pendingPrompt; }
+    // Supersedes anything still in flight for this editor.
+    aiScheduler->cancel(this);
+    ++aiRequestId;
+    if (!aiBusy) saveSnapshot();
+    aiBusy = false;
+    aiApplied = 0;
+
+    KeroMixAIAudioProcessor::ParameterTransaction t;
+    JsonWriter json(1024);
+    json.beginObject();
+    for (auto& [index, value] : targets)
+    {
+        if (!juce::isPositiveAndBelow(index, NUM_PARAMS)) continue;
+        stageParam(t, index, value);
+        json.key(paramIDs[index].toRawUTF8()).value((double)value);
+    }
+    json.endObject();
+    const auto pj = juce::String::fromUTF8(json.getData(), (int)json.getSize());
+    aiApplied = audioProcessor.applyTransaction(t);
+
+    chatHistory.push_back({ "user",      userEntry });
+    chatHistory.push_back({ "assistant", pj });
+    if ((int)chatHistory.size() > MAX_HISTORY * 2)
+        chatHistory.erase(chatHistory.begin(), chatHistory.begin() + 2);
 
-    auto parts = juce::StringArray::fromTokens(full, "|||", "");
-    auto uText = parts[0];
-    auto curJson = parts.size() > 1 ? parts[1] : "{}";
-    auto locked = parts.size() > 2 ? parts[2] : "";
-    auto spec = parts.size() > 3 ? parts[3] : "";
+    promptInput.clear();
+    statusLabel.setText(aiApplied > 0 ? source + " (" + juce::String(aiApplied) + " params)"
+                                      : juce::String("Nothing to change (locked or at limit)."),
+                        juce::dontSendNotification);
+    if (aiApplied > 0) offerBeforeAfter();
+    refreshCacheStats();
+    promptFinished();
+}
 
+juce::MemoryBlock KeroMixAIAudioProcessorEditor::buildRequestBody(const juce::String& uText, const juce::String& curJson,
+                                                                  const juce::String& locked, const juce::String& spec)
+{
     juce::String lockNote = locked.isEmpty()
         ? "No params locked."
         : "LOCKED - do NOT change: " + locked + ". Omit from JSON.";
@@ -361,108 +633,142 @@ void KeroMixAIAudioProcessorEditor::run()
         "airy=+revMix+revSize.dry=-revMix-delayMix.muddy=-lowG-midG.harsh=-highG. "
         "6.JSON only. No markdown.";
 
-    auto esc = [](const juce::String& s) -> juce::String {
-        juce::String r;
-        for (int i = 0; i < s.length(); ++i) {
-            auto c = s[i];
-            if (c == '"')  r << "\\\"";
-            else if (c == '\\') r << "\\\\";
-            else if (c == '\n') r << "\\n";
-            else if (c == '\r') r << "\\r";
-            else if (c == '\t') r << "\\t";
-            else              r << juce::String::charToString(c);
-        }
-        return r;
-        };
+    auto& w = requestWriter;
+    w.reset();
+    w.beginObject()
+        .key("model").value("llama-3.1-8b-instant")
+        .key("messages").beginArray();
 
-    juce::String msgs = "[{\"role\":\"system\",\"content\":\"" + esc(sys) + "\"}";
+    w.beginObject().key("role").value("system").key("content").value(sys).endObject();
     for (auto& m : chatHistory)
-        msgs += ",{\"role\":\"" + esc(m.role) + "\",\"content\":\"" + esc(m.content) + "\"}";
-    juce::String uc = "Spectrum:" + spec + " Params:" + curJson + " Request:" + esc(uText);
-    msgs += ",{\"role\":\"user\",\"content\":\"" + esc(uc) + "\"}]";
-
-    juce::String body;
-    body << "{\"model\":\"llama-3.1-8b-instant\","
-        << "\"messages\":" << msgs << ","
-        << "\"max_tokens\":300,\"temperature\":0.2}";
-
-    juce::URL url("https://api.groq.com/openai/v1/chat/completions");
-    auto ws = url.withPOSTData(body).createInputStream(
-        juce::URL::InputStreamOptions(juce::URL::ParameterHandling::inPostData)
-        .withExtraHeaders("Authorization: Bearer " + groqApiKey + "\r\nContent-Type: application/json")
-        .withConnectionTimeoutMs(12000));
-
-    if (!ws) {
-        juce::MessageManager::callAsync([this]() {
-            statusLabel.setText("Connection failed.", juce::dontSendNotification);
-            sendBtn.setEnabled(true);
-            for (int i = 0; i < NUM_QUICK; ++i) quickBtns[i].setEnabled(true);
-            });
-        return;
-    }
+        w.beginObject().key("role").value(m.role).key("content").value(m.content).endObject();
+    w.beginObject().key("role").value("user").key("content")
+        .beginString().append("Spectrum:").append(spec).append(" Params:").append(curJson)
+                      .append(" Request:").append(uText).endString()
+        .endObject();
+
+    w.endArray()
+        .key("max_tokens").value(300)
+        .key("temperature").value(0.2)
+        .key("stream").value(true)
+        .endObject();
+
+    return w.toMemoryBlock();
+}
 
-    juce::String resp = ws->readEntireStreamAsString();
-    juce::String pj;
-    int ci = resp.indexOf("\"content\":\"");
-    if (ci >= 0) {
-        int bs = resp.indexOf(ci, "{");
-        if (bs >= 0) {
-            int depth = 0, be = -1;
-            for (int i = bs; i < resp.length(); ++i) {
-                if (resp[i] == '{') ++depth;
-                else if (resp[i] == '}') { if (--depth == 0) { be = i; break; } }
-            }
-            if (be > bs)
-                pj = resp.substring(bs, be + 1).replace("\\n", " ").replace("\\\"", "\"").replace("\\/", "/");
-        }
+// First {...} in the message content of a plain (non-streamed) completion.
+juce::String KeroMixAIAudioProcessorEditor::extractParamsJson(const juce::String& resp)
+{
+    JsonReader reader(resp);
+    for (auto t = reader.next(); t.type != JsonReader::Type::end && t.type != JsonReader::Type::error; t = reader.next())
+    {
+        if (t.type != JsonReader::Type::key || !t.is("content")) continue;
+
+        const auto v = reader.next();
+        if (v.type != JsonReader::Type::string) continue;
+
+        const auto content = JsonReader::toString(v);
+        const int  bs = content.indexOfChar('{');
+        if (bs < 0) return {};
+
+        const auto   text = content.substring(bs);
+        JsonReader   object(text);
+        for (auto o = object.next(); o.type != JsonReader::Type::end && o.type != JsonReader::Type::error; o = object.next())
+            if (object.getDepth() == 0)
+                return juce::String::fromUTF8(text.toRawUTF8(), (int)object.getPosition());
+        return {};
     }
+    return {};
+}
+
+void KeroMixAIAudioProcessorEditor::finishAiRequest(AiScheduler::Status status, bool streamed, const juce::String& pj,
+                                                    const juce::String& resp, const juce::String& userEntry)
+{
+    aiBusy = false;
+    if (status == AiScheduler::Status::cancelled) { promptFinished(); return; }
 
     if (pj.isEmpty()) {
-        juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
-            .getChildFile("keromix_debug.txt").replaceWithText(resp);
-        juce::MessageManager::callAsync([this]() {
-            statusLabel.setText("Parse failed. See keromix_debug.txt", juce::dontSendNotification);
-            sendBtn.setEnabled(true);
-            for (int i = 0; i < NUM_QUICK; ++i) quickBtns[i].setEnabled(true);
-            });
+        // A stream cut off after some values landed: keep them, but don't cache.
+        if (aiApplied > 0) {
+            statusLabel.setText("AI partially applied (" + juce::String(aiApplied) + " params)",
+                                juce::dontSendNotification);
+            offerBeforeAfter();
+            promptFinished();
+            return;
+        }
+        if (resp.isEmpty()) {
+            statusLabel.setText(status == AiScheduler::Status::timedOut ? "Request timed out." : "Connection failed.",
+                                juce::dontSendNotification);
+            promptFinished();
+            return;
+        }
+        statusLabel.setText("Parse failed. Try rephrasing.", juce::dontSendNotification);
+        promptFinished();
         return;
     }
 
-    chatHistory.push_back({ "user",      "Params:" + curJson + " Request:" + uText });
+    chatHistory.push_back({ "user",      userEntry });
     chatHistory.push_back({ "assistant", pj });
     if ((int)chatHistory.size() > MAX_HISTORY * 2)
         chatHistory.erase(chatHistory.begin(), chatHistory.begin() + 2);
 
-    juce::MessageManager::callAsync([this, pj]() { applyParamsFromJson(pj); });
+    if (!streamed) applyParamsFromJson(pj);
+
+    if (cacheEnabled)
+    {
+        std::vector<ResponseCache::Delta> deltas;
+        for (auto& [index, value] : parseParamsJson(pj))
+            deltas.push_back({ index, value - aiRequestValues[index] });
+        responseCache->store(aiCacheKey, deltas);
+        refreshCacheStats();
+    }
+
+    promptInput.clear();
+    statusLabel.setText("AI applied! (" + juce::String(aiApplied) + " params)", juce::dontSendNotification);
+    if (aiApplied > 0) offerBeforeAfter();
+    promptFinished();
 }
 
-void KeroMixAIAudioProcessorEditor::applyParamsFromJson(const juce::String& json)
+bool KeroMixAIAudioProcessorEditor::stageParam(KeroMixAIAudioProcessor::ParameterTransaction& t,
+                                               int index, float value) const
 {
-    int applied = 0;
-    for (int i = 0; i < NUM_PARAMS; ++i)
+    if (isParamInLockedGroup(index)) return false;
+    t.set(paramIDs[index], value);
+    return true;
+}
+
+std::vector<std::pair<int, float>> KeroMixAIAudioProcessorEditor::parseParamsJson(const juce::String& json) const
+{
+    // Numeric members of the outermost object; anything nested is skipped.
+    std::vector<std::pair<int, float>> values;
+    JsonReader reader(json);
+    for (auto t = reader.next(); t.type != JsonReader::Type::end && t.type != JsonReader::Type::error; t = reader.next())
     {
-        if (isParamInLockedGroup(i)) continue;
-        juce::String search = "\"" + paramIDs[i] + "\":";
-        int pos = json.indexOf(search);
-        if (pos < 0) continue;
-        pos += search.length();
-        while (pos < json.length() && json[pos] == ' ') ++pos;
-        int end = pos;
-        while (end < json.length() &&
-            (json[end] == '-' || json[end] == '.' || (json[end] >= '0' && json[end] <= '9'))) ++end;
-        if (end > pos) {
-            float v = json.substring(pos, end).getFloatValue();
-            if (auto* param = audioProcessor.apvts.getParameter(paramIDs[i])) {
-                auto range = audioProcessor.apvts.getParameterRange(paramIDs[i]);
-                param->setValueNotifyingHost(range.convertTo0to1(juce::jlimit(range.start, range.end, v)));
-                ++applied;
-            }
-        }
+        if (t.type == JsonReader::Type::objectEnd && reader.getDepth() == 0) break;
+        if (t.type != JsonReader::Type::key || reader.getDepth() != 1) continue;
+
+        const int  index = paramLookup.find(t.text, t.length);
+        const auto v = reader.next();
+        if (index >= 0 && v.type == JsonReader::Type::number)
+            values.emplace_back(index, (float)JsonReader::toDouble(v));
     }
-    promptInput.clear();
-    statusLabel.setText("AI applied! (" + juce::String(applied) + " params)", juce::dontSendNotification);
-    sendBtn.setEnabled(true);
-    for (int i = 0; i < NUM_QUICK; ++i) quickBtns[i].setEnabled(true);
+    return values;
+}
+
+void KeroMixAIAudioProcessorEditor::applyParamsFromJson(const juce::String& json)
+{
+    KeroMixAIAudioProcessor::ParameterTransaction t;
+    for (auto& [index, value] : parseParamsJson(json))
+        stageParam(t, index, value);
+    aiApplied += audioProcessor.applyTransaction(t);
+}
+
+void KeroMixAIAudioProcessorEditor::applyStreamedParam(const juce::String& key, float value)
+{
+    KeroMixAIAudioProcessor::ParameterTransaction t;
+    const int i = paramLookup.find(key);
+    if (i >= 0 && stageParam(t, i, value) && audioProcessor.applyTransaction(t) > 0)
+        statusLabel.setText("Applying... (" + juce::String(++aiApplied) + " params)", juce::dontSendNotification);
 }
 
 // ── Draw helpers ──────────────────────────────────────────────────────────────
@@ -505,7 +811,30 @@ void KeroMixAIAudioProcessorEditor::drawSectionBg(juce::Graphics& g,
 }
 
 // ── Paint ─────────────────────────────────────────────────────────────────────
+// Everything except the spectrum bars is static, so it is drawn once into
+// an image at the display's pixel scale and blitted afterwards. The image is
+// rebuilt only after a resize or a change of scale.
 void KeroMixAIAudioProcessorEditor::paint(juce::Graphics& g)
+{
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (!chrome.isValid() || scale != chromeScale)
+    {
+        chromeScale = scale;
+        chrome = juce::Image(juce::Image::RGB, juce::jmax(1, juce::roundToInt((float)getWidth() * scale)),
+                             juce::jmax(1, juce::roundToInt((float)getHeight() * scale)), false);
+        juce::Graphics cg(chrome);
+        cg.addTransform(juce::AffineTransform::scale(scale));
+        paintChrome(cg);
+    }
+    g.drawImageTransformed(chrome, juce::AffineTransform::scale(1.f / chromeScale));
+
+    for (int i = 0; i < 3; ++i)
+        if (g.clipRegionIntersects(specBars[i].getSmallestIntegerContainer()))
+            drawSpectrumBar(g, specBars[i].getX(), specBars[i].getY(), specBars[i].getWidth(),
+                            specBars[i].getHeight(), specLevels[i], specColours[i]);
+}
+
+void KeroMixAIAudioProcessorEditor::paintChrome(juce::Graphics& g)
 {
     const float W = (float)getWidth(), H = (float)getHeight();
     const float pad = 10.f;
@@ -557,15 +886,11 @@ void KeroMixAIAudioProcessorEditor::paint(juce::Graphics& g)
     g.setFont(juce::Font(9.f, juce::Font::bold));
     g.drawText("SPECTRUM", (int)rightX + 10, (int)(dspY + 262), 65, 12, juce::Justification::left, false);
 
-    float bW = 22.f, bH = 32.f, bY = dspY + 262.f;
-    float bX = rightX + rightW / 2.f - bW * 1.5f - 4.f;
-    drawSpectrumBar(g, bX, bY, bW, bH, specLow, juce::Colour(0xff66bb6a));
-    drawSpectrumBar(g, bX + bW + 4, bY, bW, bH, specMid, juce::Colour(0xff42a5f5));
-    drawSpectrumBar(g, bX + bW * 2 + 8, bY, bW, bH, specHigh, juce::Colour(0xffef5350));
+    const char* barNames[3] = { "L", "M", "H" };
     g.setFont(juce::Font(8.f)); g.setColour(juce::Colour(0xff999999));
-    g.drawText("L", (int)bX, (int)(bY + bH + 1), (int)bW, 10, juce::Justification::centred, false);
-    g.drawText("M", (int)(bX + bW + 4), (int)(bY + bH + 1), (int)bW, 10, juce::Justification::centred, false);
-    g.drawText("H", (int)(bX + bW * 2 + 8), (int)(bY + bH + 1), (int)bW, 10, juce::Justification::centred, false);
+    for (int i = 0; i < 3; ++i)
+        g.drawText(barNames[i], (int)specBars[i].getX(), (int)(specBars[i].getBottom() + 1),
+                   (int)specBars[i].getWidth(), 10, juce::Justification::centred, false);
 }
 
 // ── Resized ───────────────────────────────────────────────────────────────────
@@ -580,6 +905,15 @@ void KeroMixAIAudioProcessorEditor::resized()
     const float rightX = leftW + 4.f;
     const float rightW = W - rightX - pad;
 
+    chrome = {};
+
+    {
+        const float bW = 22.f, bH = 32.f, bY = pad + 48.f + 262.f;
+        const float bX = rightX + rightW / 2.f - bW * 1.5f - 4.f;
+        for (int i = 0; i < 3; ++i)
+            specBars[i] = { bX + (bW + 4.f) * (float)i, bY, bW, bH };
+    }
+
     auto placeRow = [&](int startIdx, int count, float rx, float ry, float rw, float rh, int topSkip)
         {
             const int kW = 58, kH = 58, lH = 14;
@@ -616,6 +950,13 @@ void KeroMixAIAudioProcessorEditor::resized()
     placeRow(12, 3, pad + 6 + colW + 6, dspY, colW - 4, 90.f, 22);
     placeRow(15, 4, pad + 6 + colW + 6, dspY + 136.f, colW - 4, 90.f, 22);
 
+    {
+        float rX = pad + 10 + colW + 6, rW = colW - 12, rY = dspY + 136.f + 108.f;
+        irModeBtn.setBounds((int)rX, (int)rY, 100, 22);
+        irLoadBtn.setBounds((int)(rX + rW - 44), (int)rY, 44, 22);
+        irNameLabel.setBounds((int)rX, (int)(rY + 26), (int)rW, 16);
+    }
+
     {
         labels[19].setBounds((int)(pad + 8), (int)(H - pad - 34), 52, 16);
         sliders[19].setBounds((int)(pad + 62), (int)(H - pad - 38), (int)(leftW - 74), 32);
@@ -629,6 +970,12 @@ void KeroMixAIAudioProcessorEditor::resized()
 
     settingsBtn.setBounds((int)(W - pad - 32), (int)(pad + 10), 24, 24);
 
+   #if KEROMIX_DSP_LOAD
+    dspLoadBtn.setBounds((int)(W - pad - 72), (int)(pad + 10), 36, 24);
+    if (dspLoadPanel)
+        dspLoadPanel->setBounds((int)(W - 330), 40, 320, 160);
+   #endif
+
     {
         float aiX = rightX + 8, aiW = rightW - 16;
         float aiY = dspY + 22;
@@ -643,8 +990,10 @@ void KeroMixAIAudioProcessorEditor::resized()
         promptInput.setBounds((int)aiX, (int)pY, (int)(aiW - 68), 28);
         sendBtn.setBounds((int)(aiX + aiW - 64), (int)pY, 60, 28);
 
+        const float morphW = morphSlider.isVisible() ? 96.f : 0.f;
         undoBtn.setBounds((int)aiX, (int)(pY + 34), 56, 22);
-        statusLabel.setBounds((int)(aiX + 62), (int)(pY + 36), (int)(aiW - 62), 18);
+        statusLabel.setBounds((int)(aiX + 62), (int)(pY + 36), (int)(aiW - 62 - morphW), 18);
+        morphSlider.setBounds((int)(aiX + aiW - morphW), (int)(pY + 34), (int)morphW, 22);
     }
 
     {
@@ -658,7 +1007,7 @@ void KeroMixAIAudioProcessorEditor::resized()
     }
 
     if (settingsPanel)
-        settingsPanel->setBounds((int)(W - 290), 40, 270, 170);
+        settingsPanel->setBounds(getSettingsBounds());
 }
 
 void KeroMixAIAudioProcessorEditor::mouseDown(const juce::MouseEvent&)
@@ -1,13 +1,24 @@
 #pragma once
 #include <JuceHeader.h>
+#include "AiScheduler.h"
+#include "IntentEngine.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include "LlmStream.h"
 #include "PluginProcessor.h"
+#include "ResponseCache.h"
 
-// ─── Settings Screen (API Key) ────────────────────────────────────────────────
+// ─── Settings Screen (API Key, endpoint) ─────────────────────────────────────
 class SettingsComponent : public juce::Component
 {
 public:
-    std::function<void(const juce::String&)> onKeyEntered;
+    // An empty key keeps the saved one; an empty endpoint means Groq.
+    std::function<void(const juce::String& key, const juce::String& endpoint)> onSave;
     std::function<void()> onClose;
+    std::function<void()> onClearCache;
+
+    // The editor places the panel this size, 10 px in from its right edge.
+    static const int WIDTH = 270, HEIGHT = 270;
 
     SettingsComponent()
     {
@@ -29,12 +40,23 @@ public:
         keyInput.setPasswordCharacter(0x25CF);
         addAndMakeVisible(keyInput);
 
+        endpointLabel.setText("Endpoint (OpenAI-compatible)", juce::dontSendNotification);
+        endpointLabel.setFont(juce::Font(12.f));
+        endpointLabel.setColour(juce::Label::textColourId, juce::Colour(0xff666666));
+        addAndMakeVisible(endpointLabel);
+
+        endpointInput.setTextToShowWhenEmpty("api.groq.com (default)", juce::Colour(0xffaaaaaa));
+        endpointInput.setFont(juce::Font(12.f));
+        endpointInput.setColour(juce::TextEditor::backgroundColourId, juce::Colour(0xfff5faf5));
+        endpointInput.setColour(juce::TextEditor::outlineColourId, juce::Colour(0xff99CC00));
+        endpointInput.setColour(juce::TextEditor::textColourId, juce::Colour(0xff333333));
+        addAndMakeVisible(endpointInput);
+
         saveBtn.setButtonText("Save");
         saveBtn.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff99CC00));
         saveBtn.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
         saveBtn.onClick = [this]() {
-            auto key = keyInput.getText().trim();
-            if (key.isNotEmpty() && onKeyEntered) onKeyEntered(key);
+            if (onSave) onSave(keyInput.getText().trim(), endpointInput.getText().trim());
             };
         addAndMakeVisible(saveBtn);
 
@@ -49,6 +71,26 @@ public:
         hintLabel.setColour(juce::Label::textColourId, juce::Colour(0xffaaaaaa));
         hintLabel.setJustificationType(juce::Justification::centred);
         addAndMakeVisible(hintLabel);
+
+        cacheLabel.setFont(juce::Font(10.f));
+        cacheLabel.setColour(juce::Label::textColourId, juce::Colour(0xff666666));
+        addAndMakeVisible(cacheLabel);
+
+        clearCacheBtn.setButtonText("Clear cache");
+        clearCacheBtn.setColour(juce::TextButton::buttonColourId, juce::Colour(0xffeeeeee));
+        clearCacheBtn.setColour(juce::TextButton::textColourOffId, juce::Colour(0xff666666));
+        clearCacheBtn.onClick = [this]() { if (onClearCache) onClearCache(); };
+        addAndMakeVisible(clearCacheBtn);
+    }
+
+    void setCacheStats(const juce::String& text)
+    {
+        cacheLabel.setText(text, juce::dontSendNotification);
+    }
+
+    void setEndpoint(const juce::String& url)
+    {
+        endpointInput.setText(url, false);
     }
 
     void resized() override
@@ -57,8 +99,12 @@ public:
         titleLabel.setBounds(16, 8, getWidth() - 60, 28);
         apiLabel.setBounds(16, 46, getWidth() - 32, 18);
         keyInput.setBounds(16, 66, getWidth() - 32, 30);
-        saveBtn.setBounds(16, 104, 80, 28);
-        hintLabel.setBounds(16, 140, getWidth() - 32, 18);
+        endpointLabel.setBounds(16, 102, getWidth() - 32, 18);
+        endpointInput.setBounds(16, 122, getWidth() - 32, 26);
+        saveBtn.setBounds(16, 156, 80, 28);
+        hintLabel.setBounds(16, 192, getWidth() - 32, 18);
+        cacheLabel.setBounds(16, 218, getWidth() - 32, 16);
+        clearCacheBtn.setBounds(16, 238, 90, 22);
     }
 
     void paint(juce::Graphics& g) override
@@ -69,16 +115,110 @@ public:
     }
 
 private:
-    juce::Label      titleLabel, apiLabel, hintLabel;
-    juce::TextEditor keyInput;
-    juce::TextButton saveBtn, closeBtn;
+    juce::Label      titleLabel, apiLabel, endpointLabel, hintLabel, cacheLabel;
+    juce::TextEditor keyInput, endpointInput;
+    juce::TextButton saveBtn, closeBtn, clearCacheBtn;
 };
 
 
+#if KEROMIX_DSP_LOAD
+// ─── DSP Load Panel ──────────────────────────────────────────────────────────
+class DspLoadPanel : public juce::Component,
+    private juce::Timer
+{
+public:
+    std::function<void()> onClose;
+
+    explicit DspLoadPanel(DspLoadMeter& m) : meter(m)
+    {
+        titleLabel.setText("DSP load", juce::dontSendNotification);
+        titleLabel.setFont(juce::Font("Arial", 14.f, juce::Font::bold));
+        titleLabel.setColour(juce::Label::textColourId, juce::Colour(0xff4C724D));
+        addAndMakeVisible(titleLabel);
+
+        resetBtn.setButtonText("Reset");
+        resetBtn.setColour(juce::TextButton::buttonColourId, juce::Colour(0xffeeeeee));
+        resetBtn.setColour(juce::TextButton::textColourOffId, juce::Colour(0xff666666));
+        resetBtn.onClick = [this]() { meter.requestReset(); };
+        addAndMakeVisible(resetBtn);
+
+        dumpBtn.setButtonText("Dump JSON");
+        dumpBtn.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff99CC00));
+        dumpBtn.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+        dumpBtn.onClick = [this]() { dumpJson(); };
+        addAndMakeVisible(dumpBtn);
+
+        closeBtn.setButtonText("X");
+        closeBtn.setColour(juce::TextButton::buttonColourId, juce::Colour(0xffeeeeee));
+        closeBtn.setColour(juce::TextButton::textColourOffId, juce::Colour(0xff888888));
+        closeBtn.onClick = [this]() { if (onClose) onClose(); };
+        addAndMakeVisible(closeBtn);
+
+        startTimerHz(4);
+    }
+
+    void resized() override
+    {
+        closeBtn.setBounds(getWidth() - 30, 6, 22, 22);
+        titleLabel.setBounds(10, 6, 120, 22);
+        dumpBtn.setBounds(getWidth() - 118, 6, 82, 22);
+        resetBtn.setBounds(getWidth() - 172, 6, 50, 22);
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.fillAll(juce::Colours::white);
+        g.setColour(juce::Colour(0xffdddddd));
+        g.drawRoundedRectangle(getLocalBounds().toFloat().reduced(1), 12.f, 1.5f);
+
+        g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 10.5f, juce::Font::plain));
+        float y = 36.f;
+        for (int i = 0; i < lines.size(); ++i, y += 15.f)
+        {
+            g.setColour(i == 0 ? juce::Colour(0xff5c7c5d) : juce::Colour(0xff333333));
+            g.drawText(lines[i], 10, (int)y, getWidth() - 20, 14, juce::Justification::left, false);
+        }
+    }
+
+private:
+    void timerCallback() override
+    {
+        juce::StringArray next;
+        next.add("stage        mean    p99    max  (us)   load");
+        for (int i = 0; i <= meter.getNumStages(); ++i)
+        {
+            const auto st = meter.getStats(i);
+            next.add(meter.getStageName(i).paddedRight(' ', 10)
+                + juce::String(st.meanUs, 1).paddedLeft(' ', 8)
+                + juce::String(st.p99Us, 1).paddedLeft(' ', 7)
+                + juce::String(st.maxUs, 1).paddedLeft(' ', 7)
+                + juce::String(st.loadPercent, 2).paddedLeft(' ', 12) + "%");
+        }
+        if (next == lines) return;
+        lines.swapWith(next);
+        repaint(0, 30, getWidth(), getHeight() - 30);
+    }
+
+    void dumpJson()
+    {
+        auto f = juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
+            .getChildFile("keromix_dspload_" + juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S") + ".json");
+        if (f.replaceWithText(juce::JSON::toString(meter.toJson())))
+            titleLabel.setText("Saved " + f.getFileName(), juce::dontSendNotification);
+    }
+
+    DspLoadMeter&     meter;
+    juce::StringArray lines;
+    juce::Label       titleLabel;
+    juce::TextButton  resetBtn, dumpBtn, closeBtn;
+};
+#endif
+
+
 // ─── Main Editor ─────────────────────────────────────────────────────────────
 class KeroMixAIAudioProcessorEditor : public juce::AudioProcessorEditor,
-    private juce::Thread,
-    private juce::Timer
+    private juce::Timer,
+    private juce::ChangeListener
 {
 public:
     KeroMixAIAudioProcessorEditor(KeroMixAIAudioProcessor&);
@@ -88,6 +228,16 @@ public:
     void resized() override;
     void mouseDown(const juce::MouseEvent&) override;
 
+    // ── Scripting ─────────────────────────────────────────────────────────
+    // Drives the AI path without the UI, for tools such as KeroAiBench.
+    // Nothing set here is saved.
+    void setAiEndpoint(const juce::String& url, const juce::String& apiKey = {});
+    void setResponseCacheEnabled(bool enabled) noexcept { cacheEnabled = enabled; }
+    void submitPrompt(const juce::String& prompt) { sendToGroq(prompt); }
+
+    // Called once per prompt, after whichever path answered it.
+    std::function<void()> onPromptFinished;
+
 private:
     KeroMixAIAudioProcessor& audioProcessor;
 
@@ -120,11 +270,27 @@ private:
     static const int PARAM_GROUP[NUM_PARAMS];
     bool isParamInLockedGroup(int i) const { return locked[PARAM_GROUP[i]]; }
 
+    // ── Convolution reverb ────────────────────────────────────────────────
+    juce::ToggleButton irModeBtn;
+    juce::TextButton   irLoadBtn;
+    juce::Label        irNameLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> irModeAttachment;
+    std::unique_ptr<juce::FileChooser> irChooser;
+    void chooseImpulseResponse();
+    void refreshImpulseResponseName();
+
     // ── AI UI ─────────────────────────────────────────────────────────────
     juce::TextEditor  promptInput;
     juce::TextButton  sendBtn, undoBtn;
     juce::Label       statusLabel;
 
+    // Before / after slider on the "morph" parameter, shown while the last
+    // AI change can be blended with the mix it replaced.
+    juce::Slider      morphSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> morphAttachment;
+    void offerBeforeAfter();
+    void endBeforeAfter();
+
     // AI quick commands
     static const int NUM_QUICK = 8;
     juce::TextButton  quickBtns[NUM_QUICK];
@@ -143,17 +309,31 @@ private:
     juce::TextButton  settingsBtn;
     std::unique_ptr<SettingsComponent> settingsPanel;
     void showSettings();
+    juce::Rectangle<int> getSettingsBounds() const;
     void hideSettings();
+    void refreshCacheStats();
+
+   #if KEROMIX_DSP_LOAD
+    // ── DSP load panel ────────────────────────────────────────────────────
+    juce::TextButton              dspLoadBtn;
+    std::unique_ptr<DspLoadPanel> dspLoadPanel;
+    void toggleDspLoad();
+   #endif
 
     // ── Patch UI ──────────────────────────────────────────────────────────
+    // The name field doubles as the search box: typing "bass #warm" lists
+    // matching patches, and Save stores the name with its tags.
     juce::TextButton  saveBtn, loadBtn, deleteBtn;
     juce::ComboBox    patchList;
     juce::TextEditor  patchNameInput;
+    juce::SharedResourcePointer<PatchLibrary> patchLibrary;
     void refreshPatchList();
+    void changeListenerCallback(juce::ChangeBroadcaster*) override { refreshPatchList(); }
 
     // ── Undo ──────────────────────────────────────────────────────────────
     float undoSnapshot[NUM_PARAMS] = {};
     bool  hasUndoSnapshot = false;
+    MorphEngine::State morphBefore{};
     void  saveSnapshot();
     void  restoreSnapshot();
 
@@ -162,34 +342,66 @@ private:
     std::vector<ChatMessage> chatHistory;
     static const int MAX_HISTORY = 6;
 
-    // ── FFT ───────────────────────────────────────────────────────────────
-    static const int FFT_ORDER = 11;
-    static const int FFT_SIZE = 1 << FFT_ORDER;
-    juce::dsp::FFT                       fft{ FFT_ORDER };
-    juce::dsp::WindowingFunction<float>  fftWindow{ FFT_SIZE,
-                                          juce::dsp::WindowingFunction<float>::hann };
-    float fftFifo[FFT_SIZE] = {};
-    float fftData[FFT_SIZE * 2] = {};
-    int   fftFifoIndex = 0;
-    bool  fftDataReady = false;
-    float specLow = -60.f, specMid = -60.f, specHigh = -60.f;
-
-    void processFFT();
+    // ── Spectrum ──────────────────────────────────────────────────────────
+    // Low / mid / high levels from the processor's AnalysisEngine, in dB.
+    float                  specLevels[3] = { -60.f, -60.f, -60.f };
+    int                    specSteps[3] = {};
+    uint64_t               specFrames = 0;
+    juce::Rectangle<float> specBars[3];
+    const juce::Colour     specColours[3] = { juce::Colour(0xff66bb6a), juce::Colour(0xff42a5f5),
+                                              juce::Colour(0xffef5350) };
+
     void timerCallback() override;
 
-    // ── Groq thread ───────────────────────────────────────────────────────
-    juce::String          pendingPrompt;
-    juce::CriticalSection threadLock;
-    void run() override;
+    // ── Groq requests ─────────────────────────────────────────────────────
+    // Sent through the process-wide AiScheduler; everything below runs on
+    // the message thread.
+    juce::SharedResourcePointer<AiScheduler>   aiScheduler;
+    juce::SharedResourcePointer<ResponseCache> responseCache;
+    int  aiRequestId = 0;
+    bool aiBusy = false;
+    int  aiApplied = 0;
+    bool cacheEnabled = true;
+
+    // Response keys resolve through paramLookup; requests reuse one buffer.
+    ParamLookup paramLookup{ paramIDs, NUM_PARAMS };
+    JsonWriter  requestWriter;
+
+    // What the latest request was made with, for storing its answer.
+    ResponseCache::Key aiCacheKey;
+    float              aiRequestValues[NUM_PARAMS] = {};
+
     void sendToGroq(const juce::String& prompt);
+    juce::MemoryBlock buildRequestBody(const juce::String& prompt, const juce::String& currentParams,
+                                       const juce::String& lockedList, const juce::String& spec);
+    static juce::String extractParamsJson(const juce::String& response);
+    void finishAiRequest(AiScheduler::Status status, bool streamed, const juce::String& paramsJson,
+                         const juce::String& response, const juce::String& userEntry);
     void applyParamsFromJson(const juce::String& json);
+    void applyLocally(const std::vector<std::pair<int, float>>& targets, const juce::String& userEntry,
+                      const juce::String& source);
+    std::vector<std::pair<int, float>> parseParamsJson(const juce::String& json) const;
+    void applyStreamedParam(const juce::String& key, float value);
+    bool stageParam(KeroMixAIAudioProcessor::ParameterTransaction& t, int index, float value) const;
+    void promptFinished() { if (onPromptFinished) onPromptFinished(); }
+
+    // ── API key / endpoint ────────────────────────────────────────────────
+    static constexpr const char* DEFAULT_ENDPOINT = "https://api.groq.com/openai/v1/chat/completions";
 
-    // ── API key ───────────────────────────────────────────────────────────
     juce::String groqApiKey;
+    juce::String aiEndpoint;               // empty = DEFAULT_ENDPOINT
     void         saveApiKey(const juce::String& key);
     juce::String loadApiKey();
+    void         saveEndpoint(const juce::String& url);
+    juce::String loadEndpoint();
+    juce::String getEndpoint() const { return aiEndpoint.isEmpty() ? juce::String(DEFAULT_ENDPOINT) : aiEndpoint; }
+    bool         isLocalEndpoint() const;
+    bool         needsApiKey() const { return groqApiKey.isEmpty() && aiEndpoint.isEmpty(); }
 
     // ── Draw ──────────────────────────────────────────────────────────────
+    juce::Image chrome;               // static layer, see paint()
+    float       chromeScale = 0.f;
+    void paintChrome(juce::Graphics& g);
     void drawKeropi(juce::Graphics& g, float x, float y, float scale);
     void drawSpectrumBar(juce::Graphics& g, float x, float y,
         float w, float h, float dB, juce::Colour col);
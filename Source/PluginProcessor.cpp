@@ -5,17 +5,38 @@ KeroMixAIAudioProcessor::KeroMixAIAudioProcessor()
     : AudioProcessor(BusesProperties()
         .withInput ("Input",  juce::AudioChannelSet::stereo(), true)
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
-      apvts(*this, nullptr, "Parameters", createParameterLayout())
+      apvts(*this, nullptr, "Parameters", createParameterLayout()),
+      params(apvts)
 {
+    updateTailLength(params.getTarget(ParameterSnapshot::delayTime));
 }
 
-KeroMixAIAudioProcessor::~KeroMixAIAudioProcessor() {}
+KeroMixAIAudioProcessor::~KeroMixAIAudioProcessor()
+{
+    cancelPendingUpdate();
+}
+
+static constexpr float kSilenceGain = 1.0e-6f;   // -120 dBFS
+
+static float getRoomSize(float decay, float size)
+{
+    return juce::jlimit(0.f, 1.f, decay * 0.85f + size * 0.14f);
+}
 
+static bool isSilent(const juce::AudioBuffer<float>& buffer) noexcept
+{
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        if (buffer.getMagnitude(ch, 0, buffer.getNumSamples()) > kSilenceGain)
+            return false;
+    return true;
+}
+
+// Any speaker layout up to 16 channels (9.1.6); ambisonics has no speaker
+// roles for linking and reverb routing.
 bool KeroMixAIAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
     auto out = layouts.getMainOutputChannelSet();
-    if (out != juce::AudioChannelSet::stereo() &&
-        out != juce::AudioChannelSet::mono())
+    if (out.isDisabled() || out.size() > BusRouting::MAX_CHANNELS || out.getAmbisonicOrder() >= 0)
         return false;
     return out == layouts.getMainInputChannelSet();
 }
@@ -50,31 +71,83 @@ KeroMixAIAudioProcessor::createParameterLayout()
 
     p.push_back(std::make_unique<juce::AudioParameterFloat>("aimix", "Output", 0.f, 1.f, 0.8f));
 
+    p.push_back(std::make_unique<juce::AudioParameterFloat>("compKnee",  "Knee",         0.f,  24.f,   0.f));
+    p.push_back(std::make_unique<juce::AudioParameterBool> ("compLink",  "Comp Link",    false));
+
+    p.push_back(std::make_unique<juce::AudioParameterBool>  ("delaySync", "Dly Sync",     false));
+    p.push_back(std::make_unique<juce::AudioParameterChoice>("delayDiv",  "Dly Division",
+                                                             DelayEngine::getDivisionNames(), DelayEngine::d1_4));
+
+    p.push_back(std::make_unique<juce::AudioParameterChoice>("revMode",   "Rev Mode",
+                                                             juce::StringArray{ "Algorithmic", "Convolution" }, 0));
+
+    p.push_back(std::make_unique<juce::AudioParameterChoice>("osFactor",  "Oversampling",
+                                                             juce::StringArray{ "Off", "2x", "4x", "8x" }, 0));
+    p.push_back(std::make_unique<juce::AudioParameterChoice>("osQuality", "OS Quality",
+                                                             juce::StringArray{ "Realtime (IIR, low latency)",
+                                                                                "Offline (linear phase)" }, 0));
+
+    p.push_back(std::make_unique<juce::AudioParameterChoice>("compLinkScope", "Link Scope",
+                                                             juce::StringArray{ "Front / Surround / Height",
+                                                                                "All (except LFE)" }, 0));
+
+    // Position across the MorphEngine's states; inert while none are set.
+    p.push_back(std::make_unique<juce::AudioParameterFloat>("morph", "Morph", 0.f, 1.f, 0.f));
+
     return { p.begin(), p.end() };
 }
 
-void KeroMixAIAudioProcessor::prepareToPlay(double sampleRate, int /*samplesPerBlock*/)
+void KeroMixAIAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    const int numCh = juce::jmax(1, getTotalNumOutputChannels());
+    const int numCh = juce::jlimit(1, BusRouting::MAX_CHANNELS, getTotalNumOutputChannels());
+    busRouting.prepare(getChannelLayoutOfBus(false, 0), numCh, samplesPerBlock);
 
-    for (int ch = 0; ch < numCh; ++ch)
-    {
-        for (int b = 0; b < 3; ++b)
-            eqFilters[ch][b].reset();
-        compEnv[ch]    = 0.f;
-        compGainDb[ch] = 0.f;
-    }
+    params.prepare(sampleRate);
+    morph.reset();
+    analysis.setSampleRate(sampleRate);
+
+   #if KEROMIX_DSP_LOAD
+    dspLoad.prepare(sampleRate);
+   #endif
+
+    eq.setParameters(getEqParameters());
+    eq.prepare(sampleRate, samplesPerBlock, numCh);
+
+    eqGate.prepare(sampleRate, numCh, 0.1);
+    delayGate.prepare(sampleRate, numCh, 0.0);
+    reverbGate.prepare(sampleRate, numCh, 0.0);
+    reverbGateMode = -1;
+
+    compressor.prepare(sampleRate, samplesPerBlock, numCh);
+
+    using OS = juce::dsp::Oversampling<float>;
+    for (int q = 0; q < 2; ++q)
+        for (int s = 0; s < NUM_OS_STAGES; ++s)
+        {
+            auto& os = oversamplers[q][s];
+            os = std::make_unique<OS>((size_t)numCh, (size_t)(s + 1),
+                                      q == 0 ? OS::filterHalfBandPolyphaseIIR : OS::filterHalfBandFIREquiripple,
+                                      true, true);
+            os->initProcessing((size_t)samplesPerBlock);
+            osLatency[q][s] = juce::roundToInt(os->getLatencyInSamples());
+        }
+    osCurrent = -1;
+    osFadedOut = false;
+    osRequested = osApproved = getOversamplingSetting();
+    switchOversampling(osApproved);
+    setLatencySamples(getOversamplingLatency(osCurrent));
 
     reverbEngine.setSampleRate(sampleRate);
+    convolution.prepare(sampleRate, samplesPerBlock, busRouting.getNumReverbChannels(), isNonRealtime());
 
-    delayBuffer.setSize(numCh, (int)(sampleRate * 2.1));
-    delayBuffer.clear();
-    writePos = 0;
+    delay.prepare(sampleRate, samplesPerBlock, numCh,
+                  juce::jmax(apvts.getParameterRange("delayTime").end, DelayEngine::MAX_SYNC_SECONDS));
 
-    juce::ScopedLock sl(fftLock);
-    juce::zeromem(fftFifo, sizeof(fftFifo));
-    fftFifoIndex = 0;
-    fftDataReady = false;
+    silentSamples  = 0;
+    sleeping       = false;
+    pendingChanged = 0;
+    tailDelaySeconds = tailConvolutionSeconds = -1.f;
+    updateTailLength(params.getTarget(ParameterSnapshot::delayTime));
 }
 
 void KeroMixAIAudioProcessor::releaseResources() {}
@@ -91,187 +164,566 @@ void KeroMixAIAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
 
     if (bypassed.load()) return;
 
-    // ── EQ ──────────────────────────────────────────────────────────────────
+   #if KEROMIX_DSP_LOAD
+    dspLoad.blockStarted(numSamp);
+   #endif
+    if (stageProbe != nullptr) stageProbe->blockStarted(numSamp);
+
+    using P = ParameterSnapshot;
+    uint32_t changed = params.update() | std::exchange(pendingChanged, 0u);
+    changed |= morph.process(params);
+    convolution.adoptPendingState();   // a new IR goes live even while the reverb is off
+    juce::dsp::AudioBlock<float> block(buffer);
+
+    // ── Sleep ───────────────────────────────────────────────────────────────
+    const float delaySeconds = getDelaySeconds();
+    constexpr uint32_t tailMask = P::range(P::delayTime, P::revMix) | P::range(P::delaySync, P::revMode);
+    if ((changed & tailMask) != 0   // includes morph retargets
+        || delaySeconds != tailDelaySeconds || convolution.getTailSeconds() != tailConvolutionSeconds)
+        updateTailLength(delaySeconds);
+
+    if (isSilent(buffer))
     {
-        const float lG = juce::Decibels::decibelsToGain((float)*apvts.getRawParameterValue("lowG"));
-        const float lF = (float)*apvts.getRawParameterValue("lowFreq");
-        const float mG = juce::Decibels::decibelsToGain((float)*apvts.getRawParameterValue("midG"));
-        const float mF = (float)*apvts.getRawParameterValue("midFreq");
-        const float mQ = (float)*apvts.getRawParameterValue("midQ");
-        const float hG = juce::Decibels::decibelsToGain((float)*apvts.getRawParameterValue("highG"));
-        const float hF = (float)*apvts.getRawParameterValue("highFreq");
-
-        for (int ch = 0; ch < numCh; ++ch)
-        {
-            eqFilters[ch][0].setCoefficients(juce::IIRCoefficients::makeLowShelf (sr, lF, 0.71, lG));
-            eqFilters[ch][1].setCoefficients(juce::IIRCoefficients::makePeakFilter(sr, mF, mQ,  mG));
-            eqFilters[ch][2].setCoefficients(juce::IIRCoefficients::makeHighShelf(sr, hF, 0.71, hG));
+        const bool tailDone = silentSamples >= tailSamples;
+        silentSamples += numSamp;
 
-            for (int b = 0; b < 3; ++b)
-                eqFilters[ch][b].processSamples(buffer.getWritePointer(ch), numSamp);
+        if (tailDone)
+        {
+            if (!sleeping) compressor.reset();   // as if it had released fully
+            sleeping = true;
+            pendingChanged = changed;            // acted on by the first block that runs
+
+            params.skip(P::range(P::lowG, (P::Id)(P::NUM_IDS - 1)), numSamp);
+            buffer.clear();
+            analysisRing.push(buffer.getArrayOfReadPointers(), numCh, numSamp);
+            markStage(stageAnalysis);
+
+           #if KEROMIX_DSP_LOAD
+            dspLoad.blockFinished();
+           #endif
+            return;
         }
     }
-
-    // ── Compressor ──────────────────────────────────────────────────────────
+    else
     {
-        const float threshDb  = (float)*apvts.getRawParameterValue("compThresh");
-        const float ratio     = (float)*apvts.getRawParameterValue("compRatio");
-        const float attackMs  = (float)*apvts.getRawParameterValue("compAttack");
-        const float releaseMs = (float)*apvts.getRawParameterValue("compRelease");
-        const float makeupDb  = (float)*apvts.getRawParameterValue("compMakeup");
+        silentSamples = 0;
+        sleeping      = false;
+    }
 
-        const float attackCoef  = std::exp(-1.f / (float)(sr * attackMs  * 0.001));
-        const float releaseCoef = std::exp(-1.f / (float)(sr * releaseMs * 0.001));
-        const float makeup      = juce::Decibels::decibelsToGain(makeupDb);
+    // ── EQ ──────────────────────────────────────────────────────────────────
+    {
+        constexpr uint32_t eqMask = P::range(P::lowG, P::highFreq);
 
-        for (int ch = 0; ch < numCh; ++ch)
+        if (eqGate.update(isEqNeutral(), numSamp))
         {
-            auto* data = buffer.getWritePointer(ch);
-            for (int i = 0; i < numSamp; ++i)
-            {
-                const float inDb         = juce::Decibels::gainToDecibels(std::abs(data[i]) + 1e-9f);
-                const float overDb       = inDb - threshDb;
-                const float targetGainDb = overDb > 0.f ? -(overDb * (1.f - 1.f / ratio)) : 0.f;
+            if (eqGate.wasActivated()) eq.reset();
+            eqGate.captureDry(block);
 
-                if (targetGainDb < compGainDb[ch])
-                    compGainDb[ch] = attackCoef  * compGainDb[ch] + (1.f - attackCoef)  * targetGainDb;
-                else
-                    compGainDb[ch] = releaseCoef * compGainDb[ch] + (1.f - releaseCoef) * targetGainDb;
+            for (int start = 0; start < numSamp;)
+            {
+                const bool moving = params.isAnySmoothing(eqMask);
+                const int  n      = moving ? juce::jmin(EQ_RAMP_STEP, numSamp - start) : numSamp - start;
+                if (moving) params.skip(eqMask, n);
 
-                data[i] *= juce::Decibels::decibelsToGain(compGainDb[ch]) * makeup;
+                eq.setParameters(getEqParameters());
+                eq.process(block.getSubBlock((size_t)start, (size_t)n));
+                start += n;
             }
+
+            eqGate.applyFade(block);
+        }
+        else
+        {
+            params.skip(eqMask, numSamp);
+        }
+    }
+
+    markStage(stageEq);
+
+    // ── Compressor ──────────────────────────────────────────────────────────
+    {
+        params.skip(P::range(P::compThresh, P::compMakeup) | P::bit(P::compKnee), numSamp);
+
+        CompressorEngine::Parameters cp;
+        cp.thresholdDb = params.get(P::compThresh);
+        cp.ratio       = params.get(P::compRatio);
+        cp.attackMs    = params.get(P::compAttack);
+        cp.releaseMs   = params.get(P::compRelease);
+        cp.makeupDb    = params.get(P::compMakeup);
+        cp.kneeDb      = params.get(P::compKnee);
+        cp.link        = params.get(P::compLink) > 0.5f;
+
+        compressor.setParameters(cp);
+        if ((changed & P::bit(P::compLinkScope)) != 0)
+            compressor.setLinkGroups(busRouting.getLinkGroups(params.get(P::compLinkScope) > 0.5f
+                                                                  ? BusRouting::linkAll : BusRouting::linkByBed),
+                                     numCh);
+
+        int fade = 0;
+        if (auto* os = updateOversampling(fade))
+        {
+            auto up = os->processSamplesUp(block);
+            compressor.process(up);
+            os->processSamplesDown(block);
+        }
+        else
+        {
+            compressor.process(block);
         }
+
+        if (fade != 0) buffer.applyGainRamp(0, numSamp, fade < 0 ? 1.f : 0.f, fade < 0 ? 0.f : 1.f);
     }
 
+    markStage(stageCompressor);
+
     // ── Delay ───────────────────────────────────────────────────────────────
     {
-        const float dMix = (float)*apvts.getRawParameterValue("delayMix");
-        if (dMix > 0.001f)
+        const float mix0 = params.get(P::delayMix), fb0 = params.get(P::delayFeedback);
+        params.skip(P::bit(P::delayMix) | P::bit(P::delayFeedback), numSamp);
+        const float mix1 = params.get(P::delayMix), fb1 = params.get(P::delayFeedback);
+
+        if (delayGate.update(mix0 <= 0.001f && mix1 <= 0.001f, numSamp))
         {
-            const float dT  = (float)*apvts.getRawParameterValue("delayTime");
-            const float dFb = (float)*apvts.getRawParameterValue("delayFeedback");
-            const int   dS  = juce::jmin((int)(sr * dT), delayBuffer.getNumSamples() - 1);
+            if (delayGate.wasActivated()) delay.reset();   // no stale echoes from before the pause
+            delayGate.captureDry(block);
 
-            for (int ch = 0; ch < numCh; ++ch)
-            {
-                auto* data = buffer.getWritePointer(ch);
-                auto* dBuf = delayBuffer.getWritePointer(ch);
-                int   lPos = writePos;
-
-                for (int i = 0; i < numSamp; ++i)
-                {
-                    const float dry = data[i];
-                    const int   rP  = (lPos - dS + delayBuffer.getNumSamples())
-                                      % delayBuffer.getNumSamples();
-                    const float wet = dBuf[rP];
-                    dBuf[lPos] = dry + wet * dFb;
-                    data[i]    = dry + wet * dMix;
-                    lPos = (lPos + 1) % delayBuffer.getNumSamples();
-                }
-                if (ch == 0) writePos = lPos;
-            }
+            delay.setDelayTime(delaySeconds);
+            delay.process(block, mix0, mix1, fb0, fb1);
+
+            delayGate.applyFade(block);
         }
     }
 
+    markStage(stageDelay);
+
     // ── Reverb ──────────────────────────────────────────────────────────────
+    const int  reverbMode  = params.get(P::revMode) > 0.5f && convolution.isActive() ? 1 : 0;
+    const bool modeChanged = reverbMode != reverbGateMode;
+    if (modeChanged)
     {
-        const float rMix = (float)*apvts.getRawParameterValue("revMix");
-        if (rMix > 0.001f)
+        reverbGateMode = reverbMode;
+        reverbGate.restart();
+    }
+
+    const bool reverbRuns = reverbGate.update(params.get(P::revMix) <= 0.001f, numSamp);
+    if (reverbRuns)
+    {
+        if (reverbGate.wasActivated())
         {
-            juce::Reverb::Parameters rp;
-            rp.roomSize = juce::jlimit(0.f, 1.f,
-                (float)*apvts.getRawParameterValue("revDecay") * 0.85f +
-                (float)*apvts.getRawParameterValue("revSize")  * 0.14f);
-            rp.damping  = (float)*apvts.getRawParameterValue("revDamp");
-            rp.wetLevel = rMix;
-            rp.dryLevel = 1.0f;
-            rp.width    = 1.0f;
-            reverbEngine.setParameters(rp);
-
-            if (numCh >= 2)
-                reverbEngine.processStereo(buffer.getWritePointer(0),
-                                           buffer.getWritePointer(1), numSamp);
-            else
-                reverbEngine.processMono(buffer.getWritePointer(0), numSamp);
+            if (reverbMode == 1) convolution.clearHistory();
+            else                 reverbEngine.reset();
         }
+        reverbGate.captureDry(block);
     }
 
-    // ── Master ──────────────────────────────────────────────────────────────
-    buffer.applyGain((float)*apvts.getRawParameterValue("aimix"));
+    if (reverbMode == 1)
+        convolution.setParameters(params.get(P::revDecay), params.get(P::revDamp));
 
-    // ── FFT fifo ────────────────────────────────────────────────────────────
+    // Kept current in convolution mode too, so switching back starts right.
+    if (modeChanged || (changed & P::range(P::revDecay, P::revMix)) != 0)
     {
-        juce::ScopedLock sl(fftLock);
-        const auto* L = buffer.getReadPointer(0);
-        const auto* R = (numCh > 1) ? buffer.getReadPointer(1) : L;
-        for (int i = 0; i < numSamp; ++i)
+        juce::Reverb::Parameters rp;
+        rp.roomSize = getRoomSize(params.get(P::revDecay), params.get(P::revSize));
+        rp.damping  = params.get(P::revDamp);
+        rp.wetLevel = params.get(P::revMix);
+        rp.dryLevel = 1.0f;
+        rp.width    = 1.0f;
+        reverbEngine.setParameters(rp);
+    }
+
+    if (reverbRuns)
+    {
+        const float mix = params.get(P::revMix);
+        auto runReverb = [&](const juce::dsp::AudioBlock<float>& b)
+            {
+                const int n = (int)b.getNumSamples();
+                if (reverbMode == 1)              convolution.process(b, mix, mix);
+                else if (b.getNumChannels() >= 2) reverbEngine.processStereo(b.getChannelPointer(0), b.getChannelPointer(1), n);
+                else                              reverbEngine.processMono(b.getChannelPointer(0), n);
+            };
+
+        // Wider buses go through the stereo send/return.
+        if (busRouting.needsSend())
         {
-            fftFifo[fftFifoIndex++] = (L[i] + R[i]) * 0.5f;
-            if (fftFifoIndex >= FFT_SIZE)
+            const int chunk = busRouting.getMaxSendSamples();
+            for (int start = 0; start < numSamp; start += chunk)
             {
-                fftDataReady = true;
-                fftFifoIndex = 0;
+                auto sub = block.getSubBlock((size_t)start, (size_t)juce::jmin(chunk, numSamp - start));
+                runReverb(busRouting.fillSend(sub));
+                busRouting.addReturn(sub);
             }
         }
+        else
+        {
+            runReverb(block);
+        }
+
+        reverbGate.applyFade(block);
+    }
+
+    markStage(stageReverb);
+
+    // ── Master ──────────────────────────────────────────────────────────────
+    {
+        const float g0 = params.get(P::aimix);
+        params.skip(P::aimix, numSamp);
+        const float g1 = params.get(P::aimix);
+
+        if (g0 == g1) buffer.applyGain(g1);
+        else          buffer.applyGainRamp(0, numSamp, g0, g1);
+    }
+
+    markStage(stageMaster);
+
+    // ── Analysis ring ───────────────────────────────────────────────────────
+    analysisRing.push(buffer.getArrayOfReadPointers(), numCh, numSamp);
+    markStage(stageAnalysis);
+
+   #if KEROMIX_DSP_LOAD
+    dspLoad.blockFinished();
+   #endif
+}
+
+const char* KeroMixAIAudioProcessor::getStageName(int stage)
+{
+    static const char* const names[NUM_STAGES] = { "eq", "compressor", "delay", "reverb", "master", "analysis" };
+    return juce::isPositiveAndBelow(stage, (int)NUM_STAGES) ? names[stage] : "";
+}
+
+// ── Oversampling ─────────────────────────────────────────────────────────────
+int KeroMixAIAudioProcessor::getOversamplingSetting() const
+{
+    using P = ParameterSnapshot;
+    const int stages  = juce::jlimit(0, NUM_OS_STAGES, (int)params.getTarget(P::osFactor));
+    const int quality = params.getTarget(P::osQuality) > 0.5f ? 1 : 0;
+    return stages * 2 + quality;
+}
+
+juce::dsp::Oversampling<float>* KeroMixAIAudioProcessor::getOversampler(int setting) const
+{
+    const int stages = setting / 2;
+    return stages > 0 ? oversamplers[setting % 2][stages - 1].get() : nullptr;
+}
+
+int KeroMixAIAudioProcessor::getOversamplingLatency(int setting) const
+{
+    const int stages = setting / 2;
+    return stages > 0 ? osLatency[setting % 2][stages - 1].load() : 0;
+}
+
+// Everything was allocated in prepareToPlay, so this only resets state.
+void KeroMixAIAudioProcessor::switchOversampling(int setting)
+{
+    osCurrent = setting;
+    if (auto* os = getOversampler(setting)) os->reset();
+    compressor.setSampleRate(getSampleRate() * (double)(1 << (setting / 2)));
+    tailDelaySeconds = -1.f;   // tail includes the latency; recompute next block
+}
+
+// Audio thread. Returns the oversampler for this block; `fade` is -1 when the
+// block should fade out before a switch and +1 when it fades in after one.
+// Offline renders have no message loop to wait for, so they approve at once.
+juce::dsp::Oversampling<float>* KeroMixAIAudioProcessor::updateOversampling(int& fade)
+{
+    const int wanted = getOversamplingSetting();
+    if (wanted != osRequested.load(std::memory_order_relaxed))
+    {
+        osRequested.store(wanted, std::memory_order_relaxed);
+        if (isNonRealtime()) osApproved.store(wanted, std::memory_order_release);
+        triggerAsyncUpdate();
+    }
+
+    const int approved = osApproved.load(std::memory_order_acquire);
+    if (osFadedOut)
+    {
+        if (approved != osCurrent) switchOversampling(approved);
+        osFadedOut = false;
+        fade = 1;
+    }
+    else if (approved != osCurrent)
+    {
+        osFadedOut = true;
+        fade = -1;
+    }
+    return getOversampler(osCurrent);
+}
+
+// Message thread: the host hears about the new latency before the audio
+// thread switches to it.
+void KeroMixAIAudioProcessor::handleAsyncUpdate()
+{
+    const int setting = osRequested.load(std::memory_order_relaxed);
+    setLatencySamples(getOversamplingLatency(setting));
+    osApproved.store(setting, std::memory_order_release);
+}
+
+// Seconds a signal that just stopped keeps ringing above -120 dBFS: delay
+// echoes feed the reverb, then the oversampler latency, plus a margin for
+// EQ and oversampling filter ringing. Reads the ramp targets, which carry
+// morph overrides and are valid from construction on.
+void KeroMixAIAudioProcessor::updateTailLength(float delaySeconds)
+{
+    using P = ParameterSnapshot;
+    tailDelaySeconds       = delaySeconds;
+    tailConvolutionSeconds = convolution.getTailSeconds();
+
+    float tail = 0.1f;
+    if (params.getTarget(P::delayMix) > 0.001f)
+        tail += DelayEngine::getTailSeconds(delaySeconds, params.getTarget(P::delayFeedback), kSilenceGain);
+
+    if (params.getTarget(P::revMix) > 0.001f)
+    {
+        if (params.getTarget(P::revMode) > 0.5f && convolution.isActive())
+        {
+            tail += tailConvolutionSeconds;
+        }
+        else
+        {
+            // juce::Reverb: the longest comb loop is 1617 + 23 samples at 44.1 kHz
+            // with feedback roomSize * 0.28 + 0.7, followed by four allpasses
+            // (1563 samples in total, feedback 0.5).
+            const float feedback = getRoomSize(params.getTarget(P::revDecay), params.getTarget(P::revSize)) * 0.28f + 0.7f;
+            const float loops    = std::ceil(std::log(kSilenceGain) / std::log(feedback));
+            const float diffuse  = std::ceil(std::log(kSilenceGain) / std::log(0.5f));
+            tail += (1640.f * loops + 1563.f * diffuse) / 44100.f;
+        }
     }
+
+    const double sr = getSampleRate();
+    if (sr > 0.0) tail += (float)(getLatencySamples() / sr);
+
+    tailSeconds.store(tail);
+    tailSamples = (juce::int64)(tail * sr);
+}
+
+float KeroMixAIAudioProcessor::getDelaySeconds()
+{
+    using P = ParameterSnapshot;
+    if (params.get(P::delaySync) > 0.5f)
+        if (auto* ph = getPlayHead())
+            if (auto pos = ph->getPosition())
+                if (auto bpm = pos->getBpm())
+                    return DelayEngine::getSyncedDelaySeconds(*bpm, (int)params.get(P::delayDiv));
+    return params.get(P::delayTime);
+}
+
+EqEngine::Parameters KeroMixAIAudioProcessor::getEqParameters() const
+{
+    using P = ParameterSnapshot;
+    EqEngine::Parameters ep;
+    ep.lowGainDb  = params.get(P::lowG);
+    ep.lowFreq    = params.get(P::lowFreq);
+    ep.midGainDb  = params.get(P::midG);
+    ep.midFreq    = params.get(P::midFreq);
+    ep.midQ       = params.get(P::midQ);
+    ep.highGainDb = params.get(P::highG);
+    ep.highFreq   = params.get(P::highFreq);
+    return ep;
+}
+
+// All three gains at 0 dB, now and at the end of any ramp.
+bool KeroMixAIAudioProcessor::isEqNeutral() const noexcept
+{
+    using P = ParameterSnapshot;
+    for (auto id : { P::lowG, P::midG, P::highG })
+        if (std::abs(params.get(id)) >= 1e-3f || std::abs(params.getTarget(id)) >= 1e-3f)
+            return false;
+    return true;
 }
 
 // ── State ────────────────────────────────────────────────────────────────────
+// Sessions use the binary StateCodec format; no ValueTree or XML is built
+// on save, and older XML sessions still load.
 void KeroMixAIAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    StateCodec::State state;
+    for (int i = 0; i < ParameterSnapshot::NUM_IDS; ++i)
+        state.values[i] = params.getRaw((ParameterSnapshot::Id)i);
+    state.irPath = apvts.state.getProperty("irPath").toString();
+    {
+        const juce::ScopedLock sl(morphLock);
+        state.morphStates = morphStates;
+    }
+    StateCodec::write(state, destData);
 }
 
 void KeroMixAIAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml && xml->hasTagName(apvts.state.getType()))
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+    StateCodec::State state;
+    if (sizeInBytes > 0 && StateCodec::read(data, (size_t)sizeInBytes, state))
+        applyState(state);
 }
 
-// ── Patch ────────────────────────────────────────────────────────────────────
-juce::File KeroMixAIAudioProcessor::getPatchDirectory()
+// Like replaceState: no gestures, and parameters the state does not store go
+// back to their defaults.
+void KeroMixAIAudioProcessor::applyState(const StateCodec::State& state)
+{
+    for (int i = 0; i < ParameterSnapshot::NUM_IDS; ++i)
+        if (auto* param = apvts.getParameter(ParameterSnapshot::paramIDs[i]))
+            param->setValueNotifyingHost(state.hasValue(i)
+                                             ? param->convertTo0to1(param->getNormalisableRange().snapToLegalValue(state.values[i]))
+                                             : param->getDefaultValue());
+
+    if (state.irPath.isEmpty()) apvts.state.removeProperty("irPath", nullptr);
+    else                        apvts.state.setProperty("irPath", state.irPath, nullptr);
+    restoreImpulseResponse();
+
+    auto states = state.morphStates;
+    const auto current = captureState();
+    for (auto& s : states)
+        for (size_t i = 0; i < s.size(); ++i)
+            if (std::isnan(s[i])) s[i] = current[i];
+    setMorphStates(states);
+}
+
+// ── Parameter transactions ───────────────────────────────────────────────────
+int KeroMixAIAudioProcessor::applyTransaction(const ParameterTransaction& transaction)
+{
+    std::vector<std::pair<juce::RangedAudioParameter*, float>> resolved;
+    resolved.reserve(transaction.values.size());
+    uint32_t mask = 0;
+
+    for (const auto& [paramID, value] : transaction.values)
+    {
+        auto* param = apvts.getParameter(paramID);
+        if (param == nullptr) continue;
+
+        resolved.emplace_back(param, param->convertTo0to1(param->getNormalisableRange().snapToLegalValue(value)));
+        const int index = ParameterSnapshot::indexOf(paramID);
+        if (index >= 0) mask |= ParameterSnapshot::bit((ParameterSnapshot::Id)index);
+    }
+    if (resolved.empty()) return 0;
+
+    params.transact(mask, transaction.glideSeconds, [&resolved]() {
+        for (auto& [param, normalised] : resolved) param->beginChangeGesture();
+        for (auto& [param, normalised] : resolved) param->setValueNotifyingHost(normalised);
+        for (auto& [param, normalised] : resolved) param->endChangeGesture();
+        });
+    return (int)resolved.size();
+}
+
+// ── Morph ────────────────────────────────────────────────────────────────────
+MorphEngine::State KeroMixAIAudioProcessor::captureState() const
 {
-    auto dir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
-                   .getChildFile("KeroMixAI")
-                   .getChildFile("Patches");
-    dir.createDirectory();
-    return dir;
+    MorphEngine::State state;
+    for (int i = 0; i < ParameterSnapshot::NUM_IDS; ++i)
+        state[(size_t)i] = params.getRaw((ParameterSnapshot::Id)i);
+    return state;
 }
 
-void KeroMixAIAudioProcessor::savePatch(const juce::String& name)
+void KeroMixAIAudioProcessor::setMorphStates(const std::vector<MorphEngine::State>& states)
+{
+    {
+        const juce::ScopedLock sl(morphLock);
+        const auto n = states.size() >= 2 ? juce::jmin(states.size(), (size_t)MorphEngine::MAX_STATES) : 0;
+        morphStates.assign(states.begin(), states.begin() + (std::ptrdiff_t)n);
+    }
+    morph.setStates(states, captureState());
+}
+
+// Values a patch does not store morph from their defaults.
+bool KeroMixAIAudioProcessor::setMorphPatches(const juce::StringArray& names)
+{
+    std::vector<MorphEngine::State> states;
+    for (auto& name : names)
+    {
+        auto patch = patchLibrary->find(name);
+        if (patch == nullptr) return false;
+
+        MorphEngine::State state;
+        for (int i = 0; i < ParameterSnapshot::NUM_IDS; ++i)
+        {
+            auto* param = apvts.getParameter(ParameterSnapshot::paramIDs[i]);
+            state[(size_t)i] = patch->hasValue(i) || param == nullptr
+                                   ? patch->values[i]
+                                   : param->convertFrom0to1(param->getDefaultValue());
+        }
+        states.push_back(state);
+    }
+    setMorphStates(states);
+    return states.size() >= 2;
+}
+
+// ── Impulse response ─────────────────────────────────────────────────────────
+// The IR path travels with the state so sessions and patches reload it.
+bool KeroMixAIAudioProcessor::loadImpulseResponse(const juce::File& file)
+{
+    if (!convolution.loadImpulseResponse(file)) return false;
+    apvts.state.setProperty("irPath", file.getFullPathName(), nullptr);
+    return true;
+}
+
+void KeroMixAIAudioProcessor::restoreImpulseResponse()
+{
+    const juce::String path = apvts.state.getProperty("irPath").toString();
+
+    if (path.isEmpty())
+        convolution.clearImpulseResponse();
+    else if (juce::File(path) != convolution.getImpulseResponseFile())
+        convolution.loadImpulseResponse(juce::File(path));
+}
+
+// ── Patch ────────────────────────────────────────────────────────────────────
+void KeroMixAIAudioProcessor::savePatch(const juce::String& name, const juce::StringArray& tags)
 {
     auto state = apvts.copyState();
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
     xml->setAttribute("patchName", name);
-    xml->writeToFile(getPatchDirectory().getChildFile(name + ".xml"), {});
+    if (!tags.isEmpty()) xml->setAttribute("tags", tags.joinIntoString(","));
+
+    const auto file = getPatchDirectory().getChildFile(name + ".xml");
+    if (xml->writeToFile(file, {}))
+        patchLibrary->patchSaved(file);
 }
 
 juce::StringArray KeroMixAIAudioProcessor::getSavedPatchNames()
 {
-    juce::StringArray names;
-    for (auto& f : getPatchDirectory().findChildFiles(
-             juce::File::findFiles, false, "*.xml"))
-        names.add(f.getFileNameWithoutExtension());
-    names.sort(true);
-    return names;
+    return patchLibrary->search({});
 }
 
+// Falls back to the file when the library has not seen it yet (a patch
+// copied in since the last poll).
 bool KeroMixAIAudioProcessor::loadPatch(const juce::String& name)
 {
-    auto file = getPatchDirectory().getChildFile(name + ".xml");
+    if (auto patch = patchLibrary->find(name))
+        return applyPatch(*patch);
+
+    const auto file = getPatchDirectory().getChildFile(name + ".xml");
     if (!file.existsAsFile()) return false;
-    auto xml = juce::XmlDocument::parse(file);
-    if (!xml) return false;
-    apvts.replaceState(juce::ValueTree::fromXml(*xml));
+    auto patch = PatchLibrary::parse(file);
+    return patch != nullptr && applyPatch(*patch);
+}
+
+// Patches arrive as one transaction, so a load is a single gesture per
+// parameter for the host and the mix never renders half-loaded. Host
+// session restores (setStateInformation) go through applyState instead and
+// record no gestures. Parameters the patch does not store go back to their
+// defaults.
+bool KeroMixAIAudioProcessor::applyPatch(const PatchLibrary::Patch& patch)
+{
+    clearMorph();
+
+    ParameterTransaction t;
+    for (int i = 0; i < ParameterSnapshot::NUM_IDS; ++i)
+    {
+        auto* param = apvts.getParameter(ParameterSnapshot::paramIDs[i]);
+        if (param == nullptr) continue;
+        t.set(param->paramID, patch.hasValue(i) ? patch.values[i]
+                                                : param->convertFrom0to1(param->getDefaultValue()));
+    }
+    applyTransaction(t);
+
+    if (patch.irPath.isEmpty()) apvts.state.removeProperty("irPath", nullptr);
+    else                        apvts.state.setProperty("irPath", patch.irPath, nullptr);
+    restoreImpulseResponse();
     return true;
 }
 
 bool KeroMixAIAudioProcessor::deletePatch(const juce::String& name)
 {
-    return getPatchDirectory().getChildFile(name + ".xml").deleteFile();
+    if (!getPatchDirectory().getChildFile(name + ".xml").deleteFile()) return false;
+    patchLibrary->patchDeleted(name);
+    return true;
 }
 
 // ── Editor / Factory ─────────────────────────────────────────────────────────
@@ -1,7 +1,21 @@
 #pragma once
 #include <JuceHeader.h>
+#include "AnalysisEngine.h"
+#include "AnalysisRing.h"
+#include "BusRouting.h"
+#include "CompressorEngine.h"
+#include "ConvolutionReverb.h"
+#include "DelayEngine.h"
+#include "DspLoadMeter.h"
+#include "EqEngine.h"
+#include "MorphEngine.h"
+#include "ParameterSnapshot.h"
+#include "PatchLibrary.h"
+#include "StageGate.h"
+#include "StateCodec.h"
 
-class KeroMixAIAudioProcessor : public juce::AudioProcessor
+class KeroMixAIAudioProcessor : public juce::AudioProcessor,
+                                private juce::AsyncUpdater
 {
 public:
     KeroMixAIAudioProcessor();
@@ -18,7 +32,7 @@ public:
     const juce::String getName() const override { return "KeroMixAI"; }
     bool acceptsMidi() const override { return false; }
     bool producesMidi() const override { return false; }
-    double getTailLengthSeconds() const override { return 2.0; }
+    double getTailLengthSeconds() const override { return tailSeconds.load(); }
 
     int getNumPrograms() override { return 1; }
     int getCurrentProgram() override { return 0; }
@@ -29,32 +43,132 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
-    void savePatch(const juce::String& name);
+    // Names, lookups and loads come from the shared PatchLibrary, so none of
+    // them touch the disk; only savePatch and deletePatch do.
+    void savePatch(const juce::String& name, const juce::StringArray& tags = {});
     juce::StringArray getSavedPatchNames();
     bool loadPatch(const juce::String& name);
+    bool applyPatch(const PatchLibrary::Patch& patch);
     bool deletePatch(const juce::String& name);
-    juce::File getPatchDirectory();
+    juce::File getPatchDirectory() { return PatchLibrary::getDirectory(); }
+
+    // ── Parameter transactions ────────────────────────────────────────────
+    // Message thread. Every value lands in the same audio block and glides
+    // over glideSeconds; each parameter gets a single begin/end gesture.
+    struct ParameterTransaction
+    {
+        double glideSeconds = 0.05;
+        std::vector<std::pair<juce::String, float>> values;   // id, plain value
+
+        void set(const juce::String& paramID, float value) { values.emplace_back(paramID, value); }
+        bool isEmpty() const noexcept { return values.empty(); }
+    };
+
+    // Returns the number of parameters set; unknown ids are ignored.
+    int applyTransaction(const ParameterTransaction& transaction);
+
+    // ── Morph ─────────────────────────────────────────────────────────────
+    // Message thread. Two to MorphEngine::MAX_STATES states that the "morph"
+    // parameter sweeps across; fewer ends the morph. Loading a patch ends it
+    // too.
+    MorphEngine::State captureState() const;
+    void setMorphStates(const std::vector<MorphEngine::State>& states);
+    bool setMorphPatches(const juce::StringArray& names);
+    void clearMorph() { setMorphStates({}); }
+    int  getNumMorphStates() const noexcept { return morph.getNumStates(); }
+
+    bool       loadImpulseResponse(const juce::File& file);
+    juce::File getImpulseResponseFile() const { return convolution.getImpulseResponseFile(); }
 
     juce::AudioProcessorValueTreeState apvts;
     std::atomic<bool> bypassed{ false };
 
-    static const int FFT_SIZE = 2048;
-    float fftFifo[FFT_SIZE] = {};
-    int   fftFifoIndex = 0;
-    bool  fftDataReady = false;
-    juce::CriticalSection fftLock;
+    // Room for two of the largest analysis frames.
+    AnalysisRing   analysisRing{ 2 << AnalysisEngine::MAX_ORDER };
+    AnalysisEngine analysis{ analysisRing };
+
+    // ── Stage probe ───────────────────────────────────────────────────────
+    // Optional observer told when a block starts and after each stage of
+    // processBlock. Set it only while the processor is not playing.
+    enum Stage { stageEq, stageCompressor, stageDelay, stageReverb, stageMaster, stageAnalysis, NUM_STAGES };
+    static const char* getStageName(int stage);
+
+    struct StageProbe
+    {
+        virtual ~StageProbe() = default;
+        virtual void blockStarted(int numSamples) = 0;
+        virtual void stageFinished(Stage stage) = 0;
+    };
+    void setStageProbe(StageProbe* probe) noexcept { stageProbe = probe; }
+
+   #if KEROMIX_DSP_LOAD
+    DspLoadMeter dspLoad{ NUM_STAGES, &getStageName };
+   #endif
 
 private:
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    EqEngine::Parameters getEqParameters() const;
+    bool                 isEqNeutral() const noexcept;
+
+    ParameterSnapshot params;
+    MorphEngine       morph;
+    juce::CriticalSection           morphLock;     // morphStates: any thread may save state
+    std::vector<MorphEngine::State> morphStates;   // as last set, for the session state
+
+    void applyState(const StateCodec::State& state);
+    juce::SharedResourcePointer<PatchLibrary> patchLibrary;
+
+    StageProbe* stageProbe = nullptr;
+    void markStage(Stage s) noexcept
+    {
+       #if KEROMIX_DSP_LOAD
+        dspLoad.stageFinished(s);
+       #endif
+        if (stageProbe != nullptr) stageProbe->stageFinished(s);
+    }
+
+    static const int EQ_RAMP_STEP = 32;
+    BusRouting       busRouting;
+    EqEngine         eq;
+    CompressorEngine compressor;
+
+    // Optional stages are skipped while neutral; see StageGate.
+    StageGate eqGate, delayGate, reverbGate;
+    int       reverbGateMode = -1;
+
+    // Compressor oversampling: [quality][factor - 1], all built in prepareToPlay.
+    // A setting is stages * 2 + quality. The audio thread requests one, the
+    // message thread reports its latency to the host and approves it, and
+    // the audio thread then fades the signal out for a block, switches and
+    // fades back in. Sweeping osFactor only ever approves the latest value.
+    static const int NUM_OS_STAGES = 3;   // 2x, 4x, 8x
+    std::unique_ptr<juce::dsp::Oversampling<float>> oversamplers[2][NUM_OS_STAGES];
+    std::atomic<int> osLatency[2][NUM_OS_STAGES] = {};
+    std::atomic<int> osRequested{ 0 }, osApproved{ 0 };
+    int              osCurrent = 0;       // audio thread
+    bool             osFadedOut = false;
+    juce::dsp::Oversampling<float>* getOversampler(int setting) const;
+    int  getOversamplingLatency(int setting) const;   // any thread
+    juce::dsp::Oversampling<float>* updateOversampling(int& fade);
+    void switchOversampling(int setting);
+    int  getOversamplingSetting() const;
+    void handleAsyncUpdate() override;
 
-    juce::IIRFilter eqFilters[2][3];
-    float           compEnv[2]    = { 0.f, 0.f };
-    float           compGainDb[2] = { 0.f, 0.f };
+    DelayEngine delay;
+    float       getDelaySeconds();
 
-    juce::AudioBuffer<float> delayBuffer;
-    int writePos = 0;
+    juce::Reverb      reverbEngine;
+    ConvolutionReverb convolution;
+    void              restoreImpulseResponse();
 
-    juce::Reverb reverbEngine;
+    // Sleep: once the input has been silent for longer than the tail, DSP
+    // stops until sound arrives again.
+    std::atomic<float> tailSeconds{ 0.f };
+    juce::int64        tailSamples = 0, silentSamples = 0;
+    float              tailDelaySeconds = -1.f, tailConvolutionSeconds = -1.f;
+    bool               sleeping = false;
+    uint32_t           pendingChanged = 0;   // ParameterSnapshot bits seen while asleep
+    void               updateTailLength(float delaySeconds);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KeroMixAIAudioProcessor)
 };
@@ -0,0 +1,213 @@
+#include "ResponseCache.h"
+
+static uint64_t fnv1a(uint64_t h, const void* data, size_t numBytes) noexcept
+{
+    auto* p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < numBytes; ++i)
+    {
+        h ^= p[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+// ── Keys ──────────────────────────────────────────────────────────────────────
+ResponseCache::Key ResponseCache::makeKey(const juce::String& prompt, const float* normalisedParams, int numParams,
+                                          uint32_t lockedMask, const float* spectrumDb, int numBands)
+{
+    // Two FNV-1a hashes with different offset bases: one picks the set, both
+    // must match for a hit.
+    Key key{ 0xcbf29ce484222325ull, 0x6c62272e07bb0142ull };
+    auto add = [&key](const void* data, size_t numBytes) {
+        key.hash  = fnv1a(key.hash, data, numBytes);
+        key.check = fnv1a(key.check, data, numBytes);
+        };
+
+    const auto text = prompt.trim().toLowerCase();
+    add(text.toRawUTF8(), text.getNumBytesAsUTF8());
+    add(&lockedMask, sizeof(lockedMask));
+
+    for (int i = 0; i < numParams; ++i)
+    {
+        const int32_t q = juce::roundToInt(normalisedParams[i] / PARAM_STEP);
+        add(&q, sizeof(q));
+    }
+    for (int i = 0; i < numBands; ++i)
+    {
+        const int32_t q = juce::roundToInt(spectrumDb[i] / SPECTRUM_STEP);
+        add(&q, sizeof(q));
+    }
+    return key;
+}
+
+// ── File ──────────────────────────────────────────────────────────────────────
+ResponseCache::ResponseCache()
+    : fileLock("KeroMixAIResponseCache_" + juce::String::toHexString(getFile().getFullPathName().hashCode64()))
+{
+    // Another process may be creating or replacing the file right now.
+    const juce::InterProcessLock::ScopedLockType ipl(fileLock);
+    if (!open())
+    {
+        // Unknown layout or a damaged file: start over once.
+        mapped.reset();
+        getFile().deleteFile();
+        if (!open()) mapped.reset();
+    }
+}
+
+ResponseCache::~ResponseCache() = default;
+
+juce::File& ResponseCache::fileOverride()
+{
+    static juce::File file;
+    return file;
+}
+
+void ResponseCache::setFileOverride(const juce::File& file)
+{
+    fileOverride() = file;
+}
+
+juce::File ResponseCache::getFile()
+{
+    if (fileOverride() != juce::File()) return fileOverride();
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("KeroMixAI").getChildFile("response_cache.bin");
+}
+
+ResponseCache::Entry* ResponseCache::entries() const noexcept
+{
+    return reinterpret_cast<Entry*>(static_cast<char*>(mapped->getData()) + sizeof(Header));
+}
+
+bool ResponseCache::open()
+{
+    const auto file = getFile();
+    const auto size = (juce::int64)(sizeof(Header) + sizeof(Entry) * NUM_SETS * WAYS);
+
+    if (file.getSize() != size)
+    {
+        file.getParentDirectory().createDirectory();
+        file.deleteFile();
+
+        juce::FileOutputStream out(file);
+        if (!out.openedOk()) return false;
+
+        Header h{ MAGIC, VERSION, (uint32_t)NUM_SETS, (uint32_t)WAYS, 0, 0, 0, 0 };
+        out.write(&h, sizeof(h));
+        out.writeRepeatedByte(0, (size_t)size - sizeof(h));
+        out.flush();
+        if (out.getStatus().failed()) return false;
+    }
+
+    mapped = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readWrite);
+    if (mapped->getData() == nullptr || (juce::int64)mapped->getSize() != size) return false;
+
+    const auto* h = header();
+    return h->magic == MAGIC && h->version == VERSION
+        && h->numSets == (uint32_t)NUM_SETS && h->ways == (uint32_t)WAYS;
+}
+
+uint64_t ResponseCache::checksumOf(const Entry& e) noexcept
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    h = fnv1a(h, &e.hash, sizeof(e.hash));
+    h = fnv1a(h, &e.check, sizeof(e.check));
+    h = fnv1a(h, &e.numDeltas, sizeof(e.numDeltas));
+    return fnv1a(h, e.deltas, sizeof(e.deltas[0]) * juce::jmin((uint32_t)MAX_DELTAS, e.numDeltas));
+}
+
+// ── Lookup / store ────────────────────────────────────────────────────────────
+bool ResponseCache::lookup(const Key& key, std::vector<Delta>& deltas)
+{
+    const juce::ScopedLock sl(lock);
+    const juce::InterProcessLock::ScopedLockType ipl(fileLock);
+    if (mapped == nullptr) return false;
+
+    auto* h   = header();
+    auto* set = entries() + (key.hash % NUM_SETS) * WAYS;
+
+    for (int w = 0; w < WAYS; ++w)
+    {
+        auto& e = set[w];
+        if (e.lastUsed == 0 || e.hash != key.hash || e.check != key.check
+            || e.numDeltas > (uint32_t)MAX_DELTAS || e.checksum != checksumOf(e))
+            continue;
+
+        deltas.clear();
+        for (uint32_t i = 0; i < e.numDeltas; ++i)
+            deltas.push_back({ e.deltas[i].index, e.deltas[i].amount });
+
+        e.lastUsed = ++h->tick;
+        ++h->hits;
+        return true;
+    }
+
+    ++h->misses;
+    return false;
+}
+
+void ResponseCache::store(const Key& key, const std::vector<Delta>& deltas)
+{
+    const juce::ScopedLock sl(lock);
+    const juce::InterProcessLock::ScopedLockType ipl(fileLock);
+    if (mapped == nullptr) return;
+
+    auto* h   = header();
+    auto* set = entries() + (key.hash % NUM_SETS) * WAYS;
+
+    // Same key, else an empty way, else the least recently used one.
+    Entry* target = nullptr;
+    for (int w = 0; w < WAYS && target == nullptr; ++w)
+        if (set[w].lastUsed != 0 && set[w].hash == key.hash && set[w].check == key.check)
+            target = &set[w];
+    for (int w = 0; w < WAYS && target == nullptr; ++w)
+        if (set[w].lastUsed == 0)
+            target = &set[w];
+    if (target == nullptr)
+    {
+        target = set;
+        for (int w = 1; w < WAYS; ++w)
+            if (set[w].lastUsed < target->lastUsed) target = &set[w];
+    }
+
+    Entry e{};
+    e.hash      = key.hash;
+    e.check     = key.check;
+    e.lastUsed  = ++h->tick;
+    e.numDeltas = (uint32_t)juce::jmin((int)deltas.size(), MAX_DELTAS);
+    for (uint32_t i = 0; i < e.numDeltas; ++i)
+    {
+        e.deltas[i].index  = deltas[i].index;
+        e.deltas[i].amount = deltas[i].amount;
+    }
+    e.checksum = checksumOf(e);
+    *target = e;
+}
+
+void ResponseCache::clear()
+{
+    const juce::ScopedLock sl(lock);
+    const juce::InterProcessLock::ScopedLockType ipl(fileLock);
+    if (mapped == nullptr) return;
+
+    auto* h = header();
+    h->tick = 0;
+    h->hits = h->misses = 0;
+    std::memset(entries(), 0, sizeof(Entry) * NUM_SETS * WAYS);
+}
+
+ResponseCache::Stats ResponseCache::getStats() const
+{
+    const juce::ScopedLock sl(lock);
+    Stats s;
+    s.capacity = NUM_SETS * WAYS;
+    if (mapped == nullptr) return s;
+
+    s.hits   = header()->hits;
+    s.misses = header()->misses;
+    const auto* e = entries();
+    for (int i = 0; i < NUM_SETS * WAYS; ++i)
+        if (e[i].lastUsed != 0) ++s.entries;
+    return s;
+}
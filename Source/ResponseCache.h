@@ -0,0 +1,83 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ─── Response cache ──────────────────────────────────────────────────────────
+// On-disk LRU cache of AI mix suggestions, so repeated quick commands are
+// answered locally. An entry is keyed by the prompt, the current parameters
+// (normalised and quantised), the locked groups and the quantised spectrum,
+// so nearly identical situations share an entry. It stores the suggested
+// changes as deltas from the values the request was made with.
+//
+// The file is a fixed-size, memory-mapped table of NUM_SETS sets of WAYS
+// entries. Each set evicts its least recently used entry. One instance is
+// shared by every editor in the process (hold it through a
+// juce::SharedResourcePointer). Other processes may map the same file: an
+// InterProcessLock named after the file guards creating it and every
+// lookup or store, and each entry carries a checksum, so a torn write by a
+// process that died mid-store reads as a miss.
+class ResponseCache
+{
+public:
+    static constexpr int NUM_SETS   = 128;
+    static constexpr int WAYS       = 8;     // 1024 entries, ~230 KB on disk
+    static constexpr int MAX_DELTAS = 24;
+
+    struct Key   { uint64_t hash = 0, check = 0; };
+    struct Delta { int index = 0; float amount = 0.f; };
+    struct Stats { int entries = 0, capacity = 0; uint64_t hits = 0, misses = 0; };
+
+    // Steps: parameters are compared on a 0..1 scale, spectrum in dB.
+    static constexpr float PARAM_STEP    = 1.f / 50.f;
+    static constexpr float SPECTRUM_STEP = 3.f;
+
+    static Key makeKey(const juce::String& prompt, const float* normalisedParams, int numParams,
+                       uint32_t lockedMask, const float* spectrumDb, int numBands);
+
+    ResponseCache();
+    ~ResponseCache();
+
+    // Points every instance created afterwards at another file, e.g. a
+    // temporary one for benchmarks; an empty File restores the default.
+    static void setFileOverride(const juce::File& file);
+
+    // Message thread or any other; guarded by both locks.
+    bool lookup(const Key& key, std::vector<Delta>& deltas);
+    void store(const Key& key, const std::vector<Delta>& deltas);
+    void clear();
+
+    Stats getStats() const;
+
+private:
+    struct Header
+    {
+        uint32_t magic, version, numSets, ways;
+        uint32_t tick, reserved;
+        uint64_t hits, misses;
+    };
+
+    struct Entry
+    {
+        uint64_t hash, check;
+        uint32_t lastUsed;                 // 0 = empty
+        uint32_t numDeltas;
+        struct { int32_t index; float amount; } deltas[MAX_DELTAS];
+        uint64_t checksum;                 // over everything but lastUsed
+    };
+
+    static constexpr uint32_t MAGIC   = 0x3143524b;   // "KRC1"
+    static constexpr uint32_t VERSION = 1;
+
+    static juce::File& fileOverride();
+    static juce::File  getFile();
+    static uint64_t   checksumOf(const Entry& e) noexcept;
+
+    bool    open();
+    Header* header() const noexcept { return static_cast<Header*>(mapped->getData()); }
+    Entry*  entries() const noexcept;
+
+    mutable juce::CriticalSection          lock;       // this process, taken first
+    juce::InterProcessLock                  fileLock;   // every process mapping the file
+    std::unique_ptr<juce::MemoryMappedFile> mapped;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ResponseCache)
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ─── Stage gate ──────────────────────────────────────────────────────────────
+// Decides when an optional processBlock stage can be skipped. A stage stops
+// running once it has been neutral for the hold time (long enough for filter
+// ringing to die away). When it is needed again the caller resets the stage's
+// state, and the gate crossfades from the dry signal to the stage output over
+// the fade time, so the restart cannot click.
+class StageGate
+{
+public:
+    void prepare(double sampleRate, int numChannels, double holdSeconds, double fadeSeconds = 0.005)
+    {
+        holdLength = (int)(sampleRate * holdSeconds);
+        fadeLength = juce::jmax(1, (int)(sampleRate * fadeSeconds));
+        dry.setSize(juce::jmax(1, numChannels), fadeLength);
+        restart();
+    }
+
+    // Next non-neutral block counts as an activation.
+    void restart() noexcept
+    {
+        running    = false;
+        activated  = false;
+        neutralFor = 0;
+        fadePos    = fadeLength;
+    }
+
+    // Returns true if the stage has to run for this block.
+    bool update(bool neutral, int numSamples) noexcept
+    {
+        activated = false;
+
+        if (!neutral)
+        {
+            neutralFor = 0;
+            if (!running)
+            {
+                running   = true;
+                activated = true;
+                fadePos   = 0;
+            }
+            return true;
+        }
+
+        if (!running) return false;
+
+        neutralFor += numSamples;
+        if (neutralFor >= holdLength) running = false;
+        return running;
+    }
+
+    bool wasActivated() const noexcept { return activated; }
+
+    // Around the stage: keep the dry head of the block while a fade is due.
+    void captureDry(const juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        const int n = fadeSamples(block);
+        for (int ch = 0; ch < juce::jmin((int)block.getNumChannels(), dry.getNumChannels()); ++ch)
+            juce::FloatVectorOperations::copy(dry.getWritePointer(ch), block.getChannelPointer((size_t)ch), n);
+    }
+
+    void applyFade(const juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        const int n = fadeSamples(block);
+        if (n <= 0) return;
+
+        const float step = 1.f / (float)fadeLength;
+        for (int ch = 0; ch < juce::jmin((int)block.getNumChannels(), dry.getNumChannels()); ++ch)
+        {
+            auto*       wet = block.getChannelPointer((size_t)ch);
+            const auto* d   = dry.getReadPointer(ch);
+            for (int i = 0; i < n; ++i)
+                wet[i] = d[i] + (wet[i] - d[i]) * ((float)(fadePos + i + 1) * step);
+        }
+        fadePos += n;
+    }
+
+private:
+    int fadeSamples(const juce::dsp::AudioBlock<float>& block) const noexcept
+    {
+        return juce::jmin((int)block.getNumSamples(), fadeLength - fadePos);
+    }
+
+    int  holdLength = 0, fadeLength = 1;
+    int  neutralFor = 0, fadePos = 1;
+    bool running = false, activated = false;
+
+    juce::AudioBuffer<float> dry;
+};
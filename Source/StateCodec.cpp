@@ -0,0 +1,162 @@
+#include "StateCodec.h"
+
+namespace
+{
+    constexpr uint16_t HEADER_BYTES = 12;
+    constexpr size_t   PARAM_BYTES  = 6;
+
+    struct Writer
+    {
+        char*  out;
+        size_t pos = 0;
+
+        void u16(uint16_t v) noexcept { v = juce::ByteOrder::swapIfBigEndian(v); std::memcpy(out + pos, &v, 2); pos += 2; }
+        void u32(uint32_t v) noexcept { v = juce::ByteOrder::swapIfBigEndian(v); std::memcpy(out + pos, &v, 4); pos += 4; }
+        void f32(float f) noexcept    { uint32_t v; std::memcpy(&v, &f, 4); u32(v); }
+        void bytes(const void* p, size_t n) noexcept { std::memcpy(out + pos, p, n); pos += n; }
+    };
+
+    struct Reader
+    {
+        const uint8_t* in;
+        size_t         size, pos = 0;
+
+        bool     has(size_t n) const noexcept { return size - pos >= n; }
+        uint16_t u16() noexcept { const auto v = juce::ByteOrder::littleEndianShort(in + pos); pos += 2; return v; }
+        uint32_t u32() noexcept { const auto v = juce::ByteOrder::littleEndianInt(in + pos); pos += 4; return v; }
+        float    f32() noexcept { const auto v = u32(); float f; std::memcpy(&f, &v, 4); return f; }
+    };
+}
+
+// ── Write ─────────────────────────────────────────────────────────────────────
+void StateCodec::write(const State& state, juce::MemoryBlock& dest)
+{
+    constexpr int n = ParameterSnapshot::NUM_IDS;
+
+    int numValues = 0;
+    for (int i = 0; i < n; ++i)
+        if (state.hasValue(i)) ++numValues;
+
+    const auto irBytes   = state.irPath.getNumBytesAsUTF8();
+    const auto numMorph  = juce::jmin((int)state.morphStates.size(), MorphEngine::MAX_STATES);
+    const auto morphSize = 4 + (size_t)numMorph * n * 4;
+
+    size_t size = HEADER_BYTES + (size_t)numValues * PARAM_BYTES;
+    if (irBytes > 0)   size += 8 + irBytes;
+    if (numMorph >= 2) size += 8 + morphSize;
+
+    dest.setSize(size);
+    Writer w{ static_cast<char*>(dest.getData()) };
+
+    w.u32(MAGIC);
+    w.u16(VERSION);
+    w.u16(HEADER_BYTES);
+    w.u16((uint16_t)numValues);
+    w.u16(0);
+
+    for (int i = 0; i < n; ++i)
+        if (state.hasValue(i))
+        {
+            w.u16((uint16_t)i);
+            w.f32(state.values[i]);
+        }
+
+    if (irBytes > 0)
+    {
+        w.u32(CHUNK_IR_PATH);
+        w.u32((uint32_t)irBytes);
+        w.bytes(state.irPath.toRawUTF8(), irBytes);
+    }
+
+    if (numMorph >= 2)
+    {
+        w.u32(CHUNK_MORPH);
+        w.u32((uint32_t)morphSize);
+        w.u16((uint16_t)numMorph);
+        w.u16((uint16_t)n);
+        for (int s = 0; s < numMorph; ++s)
+            for (auto v : state.morphStates[(size_t)s]) w.f32(v);
+    }
+
+    jassert(w.pos == size);
+}
+
+// ── Read ──────────────────────────────────────────────────────────────────────
+bool StateCodec::isBinary(const void* data, size_t numBytes) noexcept
+{
+    return numBytes >= HEADER_BYTES && juce::ByteOrder::littleEndianInt(data) == MAGIC;
+}
+
+bool StateCodec::read(const void* data, size_t numBytes, State& state)
+{
+    if (!isBinary(data, numBytes))
+    {
+        // Sessions saved before the binary format.
+        auto xml = juce::AudioProcessor::getXmlFromBinary(data, (int)numBytes);
+        if (xml == nullptr || xml->getChildByName("PARAM") == nullptr) return false;
+        fromXml(*xml, state);
+        return true;
+    }
+
+    Reader r{ static_cast<const uint8_t*>(data), numBytes };
+    r.pos = 4;
+    const auto version     = r.u16();
+    const auto headerBytes = r.u16();
+    const auto numValues   = r.u16();
+    if (version == 0 || headerBytes < HEADER_BYTES) return false;
+
+    r.pos = 0;
+    if (!r.has(headerBytes + (size_t)numValues * PARAM_BYTES)) return false;
+    r.pos = headerBytes;
+
+    for (int k = 0; k < numValues; ++k)
+    {
+        const auto id = r.u16();
+        const auto v  = r.f32();
+        if (id < ParameterSnapshot::NUM_IDS && std::isfinite(v)) state.values[id] = v;
+    }
+
+    while (r.has(8))
+    {
+        const auto tag = r.u32();
+        const auto len = (size_t)r.u32();
+        if (!r.has(len)) return false;
+        const auto end = r.pos + len;
+
+        if (tag == CHUNK_IR_PATH)
+        {
+            state.irPath = juce::String::fromUTF8(reinterpret_cast<const char*>(r.in + r.pos), (int)len);
+        }
+        else if (tag == CHUNK_MORPH && len >= 4)
+        {
+            const int numStates = r.u16();
+            const int perState  = r.u16();
+            if (numStates <= MorphEngine::MAX_STATES && len - 4 >= (size_t)numStates * (size_t)perState * 4)
+            {
+                state.morphStates.assign((size_t)numStates, {});
+                for (auto& s : state.morphStates)
+                {
+                    s.fill(std::numeric_limits<float>::quiet_NaN());
+                    for (int i = 0; i < perState; ++i)
+                    {
+                        const auto v = r.f32();
+                        if (i < ParameterSnapshot::NUM_IDS) s[(size_t)i] = v;
+                    }
+                }
+            }
+        }
+        r.pos = end;
+    }
+    return r.pos == r.size;   // a few bytes left over are a cut-off chunk header
+}
+
+// APVTS state XML: attributes of the root plus one PARAM child per parameter.
+void StateCodec::fromXml(const juce::XmlElement& xml, State& state)
+{
+    state.irPath = xml.getStringAttribute("irPath");
+    for (auto* param : xml.getChildWithTagNameIterator("PARAM"))
+    {
+        const int i = ParameterSnapshot::indexOf(param->getStringAttribute("id"));
+        if (i >= 0) state.values[i] = (float)param->getDoubleAttribute("value");
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <JuceHeader.h>
+#include "MorphEngine.h"
+#include "ParameterSnapshot.h"
+
+// ─── State codec ─────────────────────────────────────────────────────────────
+// Compact binary form of the plugin state, used for host sessions. All
+// numbers are little-endian:
+//
+//   header   magic "KMS1", u16 version, u16 header bytes, u16 param count,
+//            u16 reserved
+//   params   param count x { u16 stable id (ParameterSnapshot::Id), f32 }
+//   chunks   { u32 tag, u32 payload bytes, payload } until the end
+//
+// Readers skip header bytes they do not know, ids they do not know and
+// unknown chunks, so a newer plugin can add any of them without breaking
+// older sessions or older plugins. Ids missing from a state keep their
+// defaults. Reserved chunk tags for later: "AIHI" (AI history), "LOCK"
+// (locked groups).
+//
+// read() also accepts the XML blobs written by copyXmlToBinary before this
+// format existed, and fromXml() reads patch files.
+class StateCodec
+{
+public:
+    static constexpr uint32_t MAGIC   = 0x31534d4b;   // "KMS1"
+    static constexpr uint16_t VERSION = 1;
+
+    struct State
+    {
+        float                           values[ParameterSnapshot::NUM_IDS];   // NaN = not stored
+        juce::String                    irPath;
+        std::vector<MorphEngine::State> morphStates;
+
+        State() { std::fill(std::begin(values), std::end(values), std::numeric_limits<float>::quiet_NaN()); }
+        bool hasValue(int i) const noexcept { return !std::isnan(values[i]); }
+    };
+
+    static void write(const State& state, juce::MemoryBlock& dest);
+    static bool read(const void* data, size_t numBytes, State& state);
+
+    static bool isBinary(const void* data, size_t numBytes) noexcept;
+    static void fromXml(const juce::XmlElement& xml, State& state);
+
+private:
+    static constexpr uint32_t CHUNK_IR_PATH = 0x48545052;   // "RPTH"
+    static constexpr uint32_t CHUNK_MORPH   = 0x4850524d;   // "MRPH"
+};
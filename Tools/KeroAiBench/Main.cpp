@@ -0,0 +1,283 @@
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+#include "../KeroAiServer/LlmStandIn.h"
+
+// ─── KeroAiBench ─────────────────────────────────────────────────────────────
+// End-to-end latency of the AI path. A real editor is driven through
+// submitPrompt() and every run is timed from that call to the last
+// setValueNotifyingHost() it causes (seen by a parameter listener); time
+// to the first parameter is reported as well. Scenarios:
+//   local   a prompt the IntentEngine answers
+//   cache   a repeated prompt answered by the ResponseCache
+//   stream  a remote request, streamed (cache off)
+//   plain   a remote request answered with one JSON body (cache off)
+// Remote requests go to an in-process LlmStandIn unless --endpoint is
+// given; plain needs the stand-in. Nothing touches the network by default.
+// Remote times include the AiScheduler's COALESCE_MS wait, as users see it.
+// The ResponseCache lives in a temporary file, so the user's cache is never
+// read or written.
+//
+//   KeroAiBench [--runs n] [--latency ms] [--chunk-delay ms] [--chunk-chars n]
+//               [--endpoint url] [--key k] [--scenario name] [--json out.json] [--label text]
+
+namespace
+{
+    using Editor = KeroMixAIAudioProcessorEditor;
+
+    struct Scenario
+    {
+        const char* name;
+        const char* prompt;
+        bool        cache;
+        bool        plain;
+    };
+
+    const Scenario scenarios[] = {
+        { "local",  "Warmer",                                true,  false },
+        { "cache",  "make it sound like a vintage record",   true,  false },
+        { "stream", "make it sound like a vintage record",   false, false },
+        { "plain",  "make it sound like a vintage record",   false, true  },
+    };
+
+    // ── Probe ────────────────────────────────────────────────────────────────
+    // Message thread only, like the editor it watches.
+    struct ParamProbe : juce::AudioProcessorParameter::Listener
+    {
+        juce::int64 start = 0, first = 0, last = 0;
+        int         changes = 0;
+
+        void reset(juce::int64 now) { start = now; first = last = 0; changes = 0; }
+
+        void parameterValueChanged(int, float) override
+        {
+            const auto now = juce::Time::getHighResolutionTicks();
+            if (changes++ == 0) first = now;
+            last = now;
+        }
+
+        void parameterGestureChanged(int, bool) override {}
+    };
+
+    struct Stats
+    {
+        juce::String        name;
+        std::vector<double> lastMs, firstMs;
+        int                 runs = 0, failed = 0;
+
+        double percentile(const std::vector<double>& sorted, double q) const
+        {
+            if (sorted.empty()) return 0.0;
+            const auto i = (size_t)juce::jlimit(0, (int)sorted.size() - 1, (int)std::ceil(q * (double)sorted.size()) - 1);
+            return sorted[i];
+        }
+
+        double mean(const std::vector<double>& v) const
+        {
+            return v.empty() ? 0.0 : std::accumulate(v.begin(), v.end(), 0.0) / (double)v.size();
+        }
+    };
+
+    double ticksToMs(juce::int64 ticks) { return juce::Time::highResolutionTicksToSeconds(ticks) * 1000.0; }
+
+    // ── Runner ───────────────────────────────────────────────────────────────
+    class Runner
+    {
+    public:
+        Runner(KeroMixAIAudioProcessor& p, Editor& e) : proc(p), editor(e)
+        {
+            for (auto* param : proc.getParameters()) param->addListener(&probe);
+        }
+
+        ~Runner()
+        {
+            for (auto* param : proc.getParameters()) param->removeListener(&probe);
+        }
+
+        // Bench thread. Returns false on timeout.
+        bool runOnce(const Scenario& s, Stats& stats)
+        {
+            juce::WaitableEvent done;
+            juce::MessageManager::callAsync([&]() {
+                for (auto* param : proc.getParameters())
+                    if (auto* r = dynamic_cast<juce::RangedAudioParameter*>(param))
+                        r->setValueNotifyingHost(r->getDefaultValue());
+
+                editor.setResponseCacheEnabled(s.cache);
+                editor.onPromptFinished = [&done]() { done.signal(); };
+                probe.reset(juce::Time::getHighResolutionTicks());
+                editor.submitPrompt(s.prompt);
+                });
+
+            const bool finished = done.wait(60000);
+
+            juce::WaitableEvent read;
+            juce::MessageManager::callAsync([&]() {
+                editor.onPromptFinished = nullptr;
+                ++stats.runs;
+                if (!finished || probe.changes == 0) ++stats.failed;
+                else
+                {
+                    stats.firstMs.push_back(ticksToMs(probe.first - probe.start));
+                    stats.lastMs.push_back(ticksToMs(probe.last - probe.start));
+                }
+                read.signal();
+                });
+            read.wait();
+            return finished;
+        }
+
+    private:
+        KeroMixAIAudioProcessor& proc;
+        Editor&                  editor;
+        ParamProbe               probe;
+    };
+
+    // ── Output ───────────────────────────────────────────────────────────────
+    void printStats(Stats& s)
+    {
+        std::sort(s.lastMs.begin(), s.lastMs.end());
+        std::sort(s.firstMs.begin(), s.firstMs.end());
+
+        juce::String line;
+        line << s.name.paddedRight(' ', 8)
+             << juce::String(s.runs).paddedLeft(' ', 5)
+             << juce::String(s.failed).paddedLeft(' ', 7) << " |"
+             << juce::String(s.mean(s.firstMs), 2).paddedLeft(' ', 9)
+             << juce::String(s.percentile(s.firstMs, 0.5), 2).paddedLeft(' ', 9) << " |";
+        for (double q : { 0.5, 0.9, 0.99 })
+            line << juce::String(s.percentile(s.lastMs, q), 2).paddedLeft(' ', 9);
+        line << juce::String(s.lastMs.empty() ? 0.0 : s.lastMs.back(), 2).paddedLeft(' ', 9)
+             << juce::String(s.mean(s.lastMs), 2).paddedLeft(' ', 9);
+        std::cout << line << std::endl;
+    }
+
+    juce::var toVar(const Stats& s)
+    {
+        auto* o = new juce::DynamicObject();
+        o->setProperty("scenario", s.name);
+        o->setProperty("runs", s.runs);
+        o->setProperty("failed", s.failed);
+        o->setProperty("first_ms_mean", s.mean(s.firstMs));
+        o->setProperty("first_ms_p50", s.percentile(s.firstMs, 0.5));
+        o->setProperty("last_ms_mean", s.mean(s.lastMs));
+        o->setProperty("last_ms_p50", s.percentile(s.lastMs, 0.5));
+        o->setProperty("last_ms_p90", s.percentile(s.lastMs, 0.9));
+        o->setProperty("last_ms_p99", s.percentile(s.lastMs, 0.99));
+        o->setProperty("last_ms_max", s.lastMs.empty() ? 0.0 : s.lastMs.back());
+        return juce::var(o);
+    }
+}
+
+// ── Main ─────────────────────────────────────────────────────────────────────
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i) args.add(juce::CharPointer_UTF8(argv[i]));
+
+    int                 runs = 50;
+    LlmStandIn::Options serverOptions;
+    juce::String        endpoint, key, onlyScenario, label;
+    juce::File          jsonFile;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        auto value = [&]() { return i + 1 < args.size() ? args[++i] : juce::String(); };
+        if      (args[i] == "--runs")        runs                       = juce::jmax(1, value().getIntValue());
+        else if (args[i] == "--latency")     serverOptions.latencyMs    = juce::jmax(0, value().getIntValue());
+        else if (args[i] == "--chunk-delay") serverOptions.chunkDelayMs = juce::jmax(0, value().getIntValue());
+        else if (args[i] == "--chunk-chars") serverOptions.chunkChars   = juce::jmax(1, value().getIntValue());
+        else if (args[i] == "--endpoint")    endpoint                   = value();
+        else if (args[i] == "--key")         key                        = value();
+        else if (args[i] == "--scenario")    onlyScenario               = value();
+        else if (args[i] == "--label")       label                      = value();
+        else if (args[i] == "--json")        jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile(value());
+        else
+        {
+            std::cout << "usage: KeroAiBench [--runs n] [--latency ms] [--chunk-delay ms] [--chunk-chars n]\n"
+                         "                   [--endpoint url] [--key k] [--scenario name] [--json out.json] [--label text]\n";
+            return 1;
+        }
+    }
+
+    std::unique_ptr<LlmStandIn> server;
+    if (endpoint.isEmpty())
+    {
+        server = std::make_unique<LlmStandIn>(serverOptions);
+        if (!server->start())
+        {
+            std::cerr << "cannot start the stand-in server" << std::endl;
+            return 1;
+        }
+        endpoint = server->getUrl();
+    }
+
+    juce::TemporaryFile cacheFile(".bin");
+    ResponseCache::setFileOverride(cacheFile.getFile());
+
+    KeroMixAIAudioProcessor proc;
+    std::unique_ptr<juce::AudioProcessorEditor> owned(proc.createEditor());
+    auto* editor = dynamic_cast<Editor*>(owned.get());
+    if (editor == nullptr) return 1;
+    editor->setAiEndpoint(endpoint, key);
+
+    std::cout << "endpoint " << endpoint << ", " << runs << " runs per scenario\n"
+              << "scenario  runs failed |  first ms     p50 |    p50      p90      p99      max     mean (ms to last param)"
+              << std::endl;
+
+    juce::Array<juce::var> results;
+    int exitCode = 0;
+
+    // The message thread runs the dispatch loop; the editor is driven from here.
+    juce::Thread::launch([&]() {
+        Runner runner(proc, *editor);
+        for (auto& s : scenarios)
+        {
+            if (onlyScenario.isNotEmpty() && onlyScenario != s.name) continue;
+            if (s.plain && server == nullptr) continue;
+            if (server != nullptr) server->setForcePlain(s.plain);
+
+            if (juce::String(s.name) == "cache")
+            {
+                Stats warmUp;
+                runner.runOnce(s, warmUp);   // stores the entry the runs hit
+            }
+
+            Stats stats;
+            stats.name = s.name;
+
+            for (int r = 0; r < runs; ++r)
+                if (!runner.runOnce(s, stats))
+                {
+                    std::cerr << s.name << ": timed out" << std::endl;
+                    exitCode = 1;
+                    break;
+                }
+
+            printStats(stats);
+            results.add(toVar(stats));
+        }
+        juce::MessageManager::getInstance()->stopDispatchLoop();
+        });
+
+    juce::MessageManager::getInstance()->runDispatchLoop();
+    owned.reset();
+
+    if (jsonFile != juce::File())
+    {
+        auto* root = new juce::DynamicObject();
+        root->setProperty("label", label);
+        root->setProperty("runs", runs);
+        root->setProperty("latency_ms", serverOptions.latencyMs);
+        root->setProperty("chunk_delay_ms", serverOptions.chunkDelayMs);
+        root->setProperty("results", results);
+        if (!jsonFile.replaceWithText(juce::JSON::toString(juce::var(root))))
+        {
+            std::cerr << "cannot write " << jsonFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    return exitCode;
+}
@@ -0,0 +1,216 @@
+#include "LlmStandIn.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+
+namespace
+{
+    const char* getReason(int status)
+    {
+        switch (status)
+        {
+            case 200: return "OK";
+            case 400: return "Bad Request";
+            case 404: return "Not Found";
+            case 429: return "Too Many Requests";
+            case 500: return "Internal Server Error";
+            case 502: return "Bad Gateway";
+            case 503: return "Service Unavailable";
+            default:  return "Error";
+        }
+    }
+}
+
+LlmStandIn::LlmStandIn(Options o)
+    : juce::Thread("KeroLlmStandIn"), options(std::move(o))
+{
+    if (options.responses.isEmpty())
+        options.responses.add("{\"lowG\":1.5,\"highG\":-1,\"compRatio\":4.5,\"compThresh\":-20,\"revMix\":0.25}");
+    options.chunkChars = juce::jmax(1, options.chunkChars);
+    forcePlain.store(options.forcePlain);
+}
+
+LlmStandIn::~LlmStandIn()
+{
+    signalThreadShouldExit();
+    socket.close();   // unblocks waitForNextConnection()
+    stopThread(4000);
+}
+
+bool LlmStandIn::start()
+{
+    if (!socket.createListener(options.port, "127.0.0.1")) return false;
+    startThread();
+    return true;
+}
+
+juce::String LlmStandIn::getUrl() const
+{
+    return "http://127.0.0.1:" + juce::String(getPort()) + "/v1/chat/completions";
+}
+
+// ── Connections ───────────────────────────────────────────────────────────────
+void LlmStandIn::run()
+{
+    while (!threadShouldExit())
+    {
+        std::unique_ptr<juce::StreamingSocket> client(socket.waitForNextConnection());
+        if (client != nullptr) serve(*client);
+    }
+}
+
+bool LlmStandIn::readRequest(juce::StreamingSocket& client, juce::String& head, juce::MemoryBlock& body)
+{
+    constexpr int maxHead = 64 * 1024, maxBody = 4 * 1024 * 1024;
+
+    juce::MemoryOutputStream in;
+    char buffer[4096];
+    int  headEnd = -1;
+    while (headEnd < 0)
+    {
+        if (in.getDataSize() > (size_t)maxHead || client.waitUntilReady(true, 5000) != 1) return false;
+        const int n = client.read(buffer, (int)sizeof(buffer), false);
+        if (n <= 0) return false;
+        in.write(buffer, (size_t)n);
+
+        const auto* data = static_cast<const char*>(in.getData());
+        const auto* end  = data + in.getDataSize();
+        const char  blank[] = "\r\n\r\n";
+        const auto* found = std::search(data, end, blank, blank + 4);
+        if (found != end)
+        {
+            headEnd = (int)(found - data);
+            head = juce::String::fromUTF8(data, headEnd);
+        }
+    }
+
+    int contentLength = 0;
+    for (auto& line : juce::StringArray::fromLines(head))
+        if (line.startsWithIgnoreCase("Content-Length:"))
+            contentLength = line.fromFirstOccurrenceOf(":", false, false).trim().getIntValue();
+    if (!juce::isPositiveAndBelow(contentLength, maxBody + 1)) return contentLength == 0;
+
+    const size_t bodyStart = (size_t)headEnd + 4;
+    while (in.getDataSize() < bodyStart + (size_t)contentLength)
+    {
+        if (client.waitUntilReady(true, 5000) != 1) return false;
+        const int n = client.read(buffer, (int)sizeof(buffer), false);
+        if (n <= 0) return false;
+        in.write(buffer, (size_t)n);
+    }
+    body.replaceAll(static_cast<const char*>(in.getData()) + bodyStart, (size_t)contentLength);
+    return true;
+}
+
+void LlmStandIn::serve(juce::StreamingSocket& client)
+{
+    juce::String      head;
+    juce::MemoryBlock body;
+    if (!readRequest(client, head, body)) return;
+    ++numRequests;
+
+    const auto requestLine = head.upToFirstOccurrenceOf("\r\n", false, false);
+    if (!requestLine.startsWith("POST ") || !requestLine.contains("/chat/completions"))
+    {
+        sendError(client, 404);
+        return;
+    }
+
+    if (options.latencyMs > 0) wait(options.latencyMs);
+    if (threadShouldExit()) return;
+
+    if (random.nextDouble() < options.errorRate)
+    {
+        sendError(client, options.errorStatus);
+        return;
+    }
+
+    bool stream = false;
+    JsonReader reader(static_cast<const char*>(body.getData()), body.getSize());
+    for (auto t = reader.next(); t.type != JsonReader::Type::end && t.type != JsonReader::Type::error; t = reader.next())
+        if (t.type == JsonReader::Type::key && reader.getDepth() == 1 && t.is("stream"))
+            stream = reader.next().is("true");
+
+    const auto& content = options.responses[nextResponse++ % options.responses.size()];
+    if (stream && !forcePlain.load()) sendStream(client, content);
+    else                              sendPlain(client, content);
+}
+
+// ── Replies ───────────────────────────────────────────────────────────────────
+bool LlmStandIn::send(juce::StreamingSocket& client, const juce::String& text)
+{
+    const int n = (int)text.getNumBytesAsUTF8();
+    return client.write(text.toRawUTF8(), n) == n;
+}
+
+void LlmStandIn::sendError(juce::StreamingSocket& client, int status)
+{
+    JsonWriter w(256);
+    w.beginObject().key("error").beginObject()
+        .key("message").value("stand-in error").key("code").value(status)
+        .endObject().endObject();
+
+    juce::String reply;
+    reply << "HTTP/1.1 " << status << " " << getReason(status) << "\r\n"
+          << "Content-Type: application/json\r\n"
+          << "Content-Length: " << (int)w.getSize() << "\r\n";
+    if (options.retryAfterSeconds >= 0)
+        reply << "Retry-After: " << options.retryAfterSeconds << "\r\n";
+    reply << "Connection: close\r\n\r\n" << juce::String::fromUTF8(w.getData(), (int)w.getSize());
+    send(client, reply);
+}
+
+void LlmStandIn::sendPlain(juce::StreamingSocket& client, const juce::String& content)
+{
+    JsonWriter w(1024);
+    w.beginObject()
+        .key("id").value("standin-" + juce::String(numRequests.load()))
+        .key("object").value("chat.completion")
+        .key("model").value("stand-in")
+        .key("choices").beginArray().beginObject()
+            .key("index").value(0)
+            .key("message").beginObject().key("role").value("assistant").key("content").value(content).endObject()
+            .key("finish_reason").value("stop")
+        .endObject().endArray()
+        .endObject();
+
+    juce::String reply;
+    reply << "HTTP/1.1 200 OK\r\n"
+          << "Content-Type: application/json\r\n"
+          << "Content-Length: " << (int)w.getSize() << "\r\n"
+          << "Connection: close\r\n\r\n" << juce::String::fromUTF8(w.getData(), (int)w.getSize());
+    send(client, reply);
+}
+
+void LlmStandIn::sendStream(juce::StreamingSocket& client, const juce::String& content)
+{
+    if (!send(client, "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                      "Cache-Control: no-cache\r\nConnection: close\r\n\r\n"))
+        return;
+
+    JsonWriter w(512);
+    auto event = [&](const juce::String* text, bool last) {
+        w.reset();
+        w.beginObject()
+            .key("id").value("standin-" + juce::String(numRequests.load()))
+            .key("object").value("chat.completion.chunk")
+            .key("choices").beginArray().beginObject()
+                .key("index").value(0)
+                .key("delta").beginObject();
+        if (text == nullptr && !last) w.key("role").value("assistant");
+        if (text != nullptr)          w.key("content").value(*text);
+        w.endObject();
+        if (last) w.key("finish_reason").value("stop");
+        w.endObject().endArray().endObject();
+        return send(client, "data: " + juce::String::fromUTF8(w.getData(), (int)w.getSize()) + "\n\n");
+        };
+
+    if (!event(nullptr, false)) return;
+    for (int i = 0; i < content.length(); i += options.chunkChars)
+    {
+        if (options.chunkDelayMs > 0) wait(options.chunkDelayMs);
+        const auto piece = content.substring(i, i + options.chunkChars);
+        if (threadShouldExit() || !event(&piece, false)) return;
+    }
+    if (event(nullptr, true))
+        send(client, "data: [DONE]\n\n");
+}
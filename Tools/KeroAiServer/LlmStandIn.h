@@ -0,0 +1,58 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ─── LLM stand-in ────────────────────────────────────────────────────────────
+// Minimal HTTP/1.1 server that answers POST .../chat/completions like an
+// OpenAI-compatible API, with scripted model texts instead of a model.
+// Requests with "stream": true get server-sent events, one chunk per
+// CHUNK_CHARS characters, and every other request gets one JSON body.
+// Latency before the headers, a delay between chunks and a fraction of
+// error replies (with an optional Retry-After) can be injected. Connections
+// are served one at a time, which matches the AiScheduler's single worker.
+// Used by KeroAiServer (standalone) and KeroAiBench (in-process).
+class LlmStandIn : private juce::Thread
+{
+public:
+    struct Options
+    {
+        int               port = 0;               // 0 = any free port
+        int               latencyMs = 0;          // before the response headers
+        int               chunkDelayMs = 0;       // between streamed chunks
+        int               chunkChars = 8;
+        double            errorRate = 0.0;        // 0..1 of requests fail
+        int               errorStatus = 503;
+        int               retryAfterSeconds = -1; // sent with errors when >= 0
+        bool              forcePlain = false;     // ignore "stream": true
+        juce::StringArray responses;              // model texts, cycled
+    };
+
+    explicit LlmStandIn(Options options);
+    ~LlmStandIn() override;
+
+    // Opens the listening socket and starts serving; false if the port is taken.
+    bool start();
+
+    int          getPort() const noexcept { return socket.getBoundPort(); }
+    juce::String getUrl() const;
+    int          getNumRequests() const noexcept { return numRequests.load(); }
+
+    // Any thread; applies from the next request on.
+    void setForcePlain(bool plain) noexcept { forcePlain.store(plain); }
+
+private:
+    void run() override;
+    void serve(juce::StreamingSocket& client);
+    bool send(juce::StreamingSocket& client, const juce::String& text);
+    void sendError(juce::StreamingSocket& client, int status);
+    void sendPlain(juce::StreamingSocket& client, const juce::String& content);
+    void sendStream(juce::StreamingSocket& client, const juce::String& content);
+
+    static bool readRequest(juce::StreamingSocket& client, juce::String& head, juce::MemoryBlock& body);
+
+    Options               options;
+    juce::StreamingSocket socket;
+    juce::Random          random{ 1234 };
+    std::atomic<bool>     forcePlain{ false };
+    std::atomic<int>      numRequests{ 0 };
+    int                   nextResponse = 0;
+};
@@ -0,0 +1,71 @@
+#include <JuceHeader.h>
+#include "LlmStandIn.h"
+
+// ─── KeroAiServer ────────────────────────────────────────────────────────────
+// Local stand-in for the chat-completions API, so the AI path can be
+// exercised and timed without network access. Point the plugin's endpoint
+// setting (or KeroAiBench --endpoint) at the printed URL. Each non-empty
+// line of the script file is one model reply; replies are used in turn.
+//
+//   KeroAiServer [--port n] [--latency ms] [--chunk-delay ms] [--chunk-chars n]
+//                [--error-rate 0..1] [--error-status n] [--retry-after s]
+//                [--plain] [--script replies.txt]
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i) args.add(juce::CharPointer_UTF8(argv[i]));
+
+    LlmStandIn::Options o;
+    o.port = 8088;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        auto value = [&]() { return i + 1 < args.size() ? args[++i] : juce::String(); };
+        if      (args[i] == "--port")         o.port              = value().getIntValue();
+        else if (args[i] == "--latency")      o.latencyMs         = juce::jmax(0, value().getIntValue());
+        else if (args[i] == "--chunk-delay")  o.chunkDelayMs      = juce::jmax(0, value().getIntValue());
+        else if (args[i] == "--chunk-chars")  o.chunkChars        = juce::jmax(1, value().getIntValue());
+        else if (args[i] == "--error-rate")   o.errorRate         = juce::jlimit(0.0, 1.0, value().getDoubleValue());
+        else if (args[i] == "--error-status") o.errorStatus       = value().getIntValue();
+        else if (args[i] == "--retry-after")  o.retryAfterSeconds = value().getIntValue();
+        else if (args[i] == "--plain")        o.forcePlain        = true;
+        else if (args[i] == "--script")
+        {
+            const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(value());
+            if (!file.existsAsFile())
+            {
+                std::cerr << "cannot read " << file.getFullPathName() << std::endl;
+                return 1;
+            }
+            o.responses.addLines(file.loadFileAsString());
+            o.responses.removeEmptyStrings();
+        }
+        else
+        {
+            std::cout << "usage: KeroAiServer [--port n] [--latency ms] [--chunk-delay ms] [--chunk-chars n]\n"
+                         "                    [--error-rate 0..1] [--error-status n] [--retry-after s]\n"
+                         "                    [--plain] [--script replies.txt]\n";
+            return 1;
+        }
+    }
+
+    LlmStandIn server(o);
+    if (!server.start())
+    {
+        std::cerr << "cannot listen on port " << o.port << std::endl;
+        return 1;
+    }
+
+    std::cout << "serving " << server.getUrl() << " (Ctrl+C to stop)" << std::endl;
+    for (int served = 0;; juce::Thread::sleep(1000))
+    {
+        if (server.getNumRequests() != served)
+        {
+            served = server.getNumRequests();
+            std::cout << served << " requests" << std::endl;
+        }
+    }
+}
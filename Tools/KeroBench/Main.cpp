@@ -0,0 +1,326 @@
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+// ─── KeroBench ───────────────────────────────────────────────────────────────
+// Per-stage processBlock benchmark. Sweeps presets x layouts (mono, stereo,
+// 5.1, 7.1.4) x sample rates x block sizes, times every stage through the
+// processor's StageProbe and prints ns/sample and realtime factor per stage
+// and in total. --json writes the same numbers in a form that can be diffed
+// across commits. The "automate" and "morph" presets sweep the same mix
+// change back and forth once a second, as per-parameter automation and
+// through the morph parameter, so the two costs can be compared.
+//
+//   KeroBench [--seconds s] [--quick] [--preset name] [--json out.json] [--label text]
+
+namespace
+{
+    using Proc = KeroMixAIAudioProcessor;
+
+    // ── Presets ──────────────────────────────────────────────────────────────
+    enum class Motion { none, automate, morph };
+
+    struct Preset
+    {
+        const char* name;
+        std::vector<std::pair<const char*, float>> values;
+        Motion      motion = Motion::none;
+        std::vector<std::pair<const char*, float>> sweepTo;   // other end of the sweep
+    };
+
+    const std::vector<Preset>& getPresets()
+    {
+        static const std::vector<std::pair<const char*, float>> from = {
+            { "lowG", 4.f }, { "midG", -3.f }, { "highG", 2.f },
+            { "compThresh", -24.f }, { "compRatio", 8.f }, { "delayMix", 0.3f }, { "revMix", 0.3f } };
+        static const std::vector<std::pair<const char*, float>> to = {
+            { "lowG", -4.f }, { "lowFreq", 400.f }, { "midG", 3.f }, { "midFreq", 2500.f }, { "highG", -2.f },
+            { "highFreq", 12000.f }, { "compThresh", -12.f }, { "compRatio", 3.f }, { "revMix", 0.1f } };
+
+        static const std::vector<Preset> presets = {
+            { "default", {} },
+            { "fx",      { { "delayMix", 0.3f }, { "revMix", 0.3f } } },
+            { "full",    { { "lowG", 4.f }, { "midG", -3.f }, { "highG", 2.f },
+                           { "compThresh", -24.f }, { "compRatio", 8.f }, { "compKnee", 6.f },
+                           { "compLink", 1.f }, { "delayMix", 0.3f }, { "revMix", 0.3f } } },
+            { "full_os4x", { { "lowG", 4.f }, { "midG", -3.f }, { "highG", 2.f },
+                             { "compThresh", -24.f }, { "compRatio", 8.f }, { "compKnee", 6.f },
+                             { "delayMix", 0.3f }, { "revMix", 0.3f }, { "osFactor", 2.f } } },
+            { "automate",  from, Motion::automate, to },
+            { "morph",     from, Motion::morph,    to },
+        };
+        return presets;
+    }
+
+    void applyPreset(Proc& proc, const Preset& preset)
+    {
+        for (auto* p : proc.getParameters())
+            if (auto* r = dynamic_cast<juce::RangedAudioParameter*>(p))
+                r->setValueNotifyingHost(r->getDefaultValue());
+
+        for (auto& [id, v] : preset.values)
+            if (auto* r = proc.apvts.getParameter(id))
+                r->setValueNotifyingHost(r->convertTo0to1(v));
+    }
+
+    // One lane per swept parameter, in normalised values.
+    struct Lane
+    {
+        juce::RangedAudioParameter* param;
+        float                       from, to;
+    };
+
+    std::vector<Lane> makeSweep(Proc& proc, const Preset& preset)
+    {
+        std::vector<Lane> lanes;
+        if (preset.motion == Motion::none) return lanes;
+
+        for (auto& [id, v] : preset.sweepTo)
+            if (auto* r = proc.apvts.getParameter(id))
+                lanes.push_back({ r, r->getValue(), r->convertTo0to1(v) });
+
+        if (preset.motion == Motion::morph)
+        {
+            const auto a = proc.captureState();
+            for (auto& lane : lanes) lane.param->setValueNotifyingHost(lane.to);
+            const auto b = proc.captureState();
+            for (auto& lane : lanes) lane.param->setValueNotifyingHost(lane.from);
+
+            proc.setMorphStates({ a, b });
+            lanes = { { proc.apvts.getParameter("morph"), 0.f, 1.f } };
+        }
+        return lanes;
+    }
+
+    // ── Probe ────────────────────────────────────────────────────────────────
+    struct TimingProbe : Proc::StageProbe
+    {
+        juce::int64 last = 0;
+        juce::int64 ticks[Proc::NUM_STAGES] = {};
+        bool        enabled = false;
+
+        void blockStarted(int) override { last = juce::Time::getHighResolutionTicks(); }
+
+        void stageFinished(Proc::Stage s) override
+        {
+            const auto now = juce::Time::getHighResolutionTicks();
+            if (enabled) ticks[s] += now - last;
+            last = now;
+        }
+    };
+
+    struct Result
+    {
+        juce::String preset;
+        int          numChannels = 0, blockSize = 0;
+        double       sampleRate = 0.0, audioSeconds = 0.0;
+        double       stageSeconds[Proc::NUM_STAGES] = {};
+    };
+
+    Result runCase(const Preset& preset, int numCh, double sr, int blockSize, double seconds)
+    {
+        Proc proc;
+        juce::AudioProcessor::BusesLayout layout;
+        const auto set = BusRouting::getDefaultLayout(numCh);
+        layout.inputBuses.add(set);
+        layout.outputBuses.add(set);
+        proc.setBusesLayout(layout);
+        applyPreset(proc, preset);
+        const auto sweep = makeSweep(proc, preset);
+
+        proc.setRateAndBufferSizeDetails(sr, blockSize);
+        proc.prepareToPlay(sr, blockSize);
+
+        TimingProbe probe;
+        proc.setStageProbe(&probe);
+
+        // Low-passed noise around -16 dBFS RMS, so the "full" presets compress.
+        juce::Random rng(1234);
+        juce::AudioBuffer<float> source(numCh, 1 << 16);
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            float lp = 0.f;
+            for (int i = 0; i < source.getNumSamples(); ++i)
+            {
+                lp += 0.1f * (rng.nextFloat() * 2.f - 1.f - lp);
+                source.setSample(ch, i, lp * 1.2f);
+            }
+        }
+
+        juce::AudioBuffer<float> buffer(numCh, blockSize);
+        juce::MidiBuffer midi;
+        int srcPos = 0;
+        juce::int64 played = 0;
+
+        auto runBlocks = [&](juce::int64 numSamples)
+            {
+                for (juce::int64 done = 0; done < numSamples; done += blockSize)
+                {
+                    if (srcPos + blockSize > source.getNumSamples()) srcPos = 0;
+                    for (int ch = 0; ch < numCh; ++ch)
+                        buffer.copyFrom(ch, 0, source, ch, srcPos, blockSize);
+                    srcPos += blockSize;
+
+                    // Triangle, one second each way.
+                    const float t = (float)std::abs(std::fmod((double)played / sr, 2.0) - 1.0);
+                    for (auto& lane : sweep)
+                        lane.param->setValueNotifyingHost(lane.from + (lane.to - lane.from) * t);
+                    played += blockSize;
+
+                    proc.processBlock(buffer, midi);
+                }
+            };
+
+        runBlocks((juce::int64)(sr * 0.25));   // warm-up, lets parameter ramps settle
+        probe.enabled = true;
+        const auto total = (juce::int64)(sr * seconds) / blockSize * blockSize;
+        runBlocks(total);
+
+        proc.setStageProbe(nullptr);
+        proc.releaseResources();
+
+        Result r;
+        r.preset       = preset.name;
+        r.numChannels  = numCh;
+        r.blockSize    = blockSize;
+        r.sampleRate   = sr;
+        r.audioSeconds = (double)total / sr;
+        for (int s = 0; s < Proc::NUM_STAGES; ++s)
+            r.stageSeconds[s] = juce::Time::highResolutionTicksToSeconds(probe.ticks[s]);
+        return r;
+    }
+
+    // ── Output ───────────────────────────────────────────────────────────────
+    juce::String getLayoutName(int numCh)
+    {
+        switch (numCh)
+        {
+            case 1:  return "mono";
+            case 2:  return "stereo";
+            case 6:  return "5.1";
+            case 8:  return "7.1";
+            case 12: return "7.1.4";
+            default: return juce::String(numCh) + "ch";
+        }
+    }
+
+    juce::var stageVar(double secs, double audioSeconds, double samples)
+    {
+        auto* o = new juce::DynamicObject();
+        o->setProperty("ns_per_sample", secs * 1e9 / samples);
+        o->setProperty("realtime_factor", secs > 0.0 ? audioSeconds / secs : 0.0);
+        return juce::var(o);
+    }
+
+    juce::var toVar(const Result& r)
+    {
+        const double samples = r.audioSeconds * r.sampleRate;
+        auto* stages = new juce::DynamicObject();
+        double total = 0.0;
+        for (int s = 0; s < Proc::NUM_STAGES; ++s)
+        {
+            stages->setProperty(Proc::getStageName(s), stageVar(r.stageSeconds[s], r.audioSeconds, samples));
+            total += r.stageSeconds[s];
+        }
+
+        auto* o = new juce::DynamicObject();
+        o->setProperty("preset", r.preset);
+        o->setProperty("channels", r.numChannels);
+        o->setProperty("layout", getLayoutName(r.numChannels));
+        o->setProperty("sample_rate", r.sampleRate);
+        o->setProperty("block_size", r.blockSize);
+        o->setProperty("stages", juce::var(stages));
+        o->setProperty("total", stageVar(total, r.audioSeconds, samples));
+        return juce::var(o);
+    }
+
+    void printResult(const Result& r)
+    {
+        const double samples = r.audioSeconds * r.sampleRate;
+        double total = 0.0;
+        juce::String line;
+        line << juce::String(r.preset).paddedRight(' ', 10)
+             << getLayoutName(r.numChannels).paddedRight(' ', 7)
+             << juce::String(r.sampleRate / 1000.0, 1).paddedLeft(' ', 6) << "k "
+             << juce::String(r.blockSize).paddedLeft(' ', 5) << " |";
+        for (int s = 0; s < Proc::NUM_STAGES; ++s)
+        {
+            line << juce::String(r.stageSeconds[s] * 1e9 / samples, 2).paddedLeft(' ', 9);
+            total += r.stageSeconds[s];
+        }
+        line << " |" << juce::String(total * 1e9 / samples, 2).paddedLeft(' ', 9)
+             << juce::String((juce::int64)(r.audioSeconds / juce::jmax(1e-12, total))).paddedLeft(' ', 9) << "x";
+        std::cout << line << std::endl;
+    }
+}
+
+// ── Main ─────────────────────────────────────────────────────────────────────
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i) args.add(juce::CharPointer_UTF8(argv[i]));
+
+    double       seconds = 2.0;
+    bool         quick   = false;
+    juce::String onlyPreset, label;
+    juce::File   jsonFile;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        auto value = [&]() { return i + 1 < args.size() ? args[++i] : juce::String(); };
+        if      (args[i] == "--seconds") seconds    = juce::jmax(0.05, value().getDoubleValue());
+        else if (args[i] == "--quick")   quick      = true;
+        else if (args[i] == "--preset")  onlyPreset = value();
+        else if (args[i] == "--label")   label      = value();
+        else if (args[i] == "--json")    jsonFile   = juce::File::getCurrentWorkingDirectory().getChildFile(value());
+        else
+        {
+            std::cout << "usage: KeroBench [--seconds s] [--quick] [--preset name] [--json out.json] [--label text]\n";
+            return 1;
+        }
+    }
+
+    const std::vector<double> rates   = quick ? std::vector<double>{ 48000.0 }
+                                              : std::vector<double>{ 44100.0, 48000.0, 96000.0, 192000.0 };
+    const std::vector<int>    blocks  = quick ? std::vector<int>{ 64, 512, 4096 }
+                                              : std::vector<int>{ 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    const std::vector<int>    layouts = quick ? std::vector<int>{ 1, 2, 12 }
+                                              : std::vector<int>{ 1, 2, 6, 12 };
+
+    juce::String header;
+    header << "preset    layout   rate block |";
+    for (int s = 0; s < Proc::NUM_STAGES; ++s)
+        header << juce::String(Proc::getStageName(s)).paddedLeft(' ', 9);
+    header << " |    total       RT   (ns/sample)";
+    std::cout << header << std::endl;
+
+    juce::Array<juce::var> results;
+    for (auto& preset : getPresets())
+    {
+        if (onlyPreset.isNotEmpty() && onlyPreset != preset.name) continue;
+
+        for (int numCh : layouts)
+            for (double sr : rates)
+                for (int bs : blocks)
+                {
+                    auto r = runCase(preset, numCh, sr, bs, seconds);
+                    printResult(r);
+                    results.add(toVar(r));
+                }
+    }
+
+    if (jsonFile != juce::File())
+    {
+        auto* root = new juce::DynamicObject();
+        root->setProperty("label", label);
+        root->setProperty("seconds_per_case", seconds);
+        root->setProperty("results", results);
+        if (!jsonFile.replaceWithText(juce::JSON::toString(juce::var(root))))
+        {
+            std::cerr << "cannot write " << jsonFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,272 @@
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+// ─── KeroRender ──────────────────────────────────────────────────────────────
+// Headless batch renderer: streams audio files through KeroMixAIAudioProcessor
+// faster than realtime. Each pool worker owns one processor instance and pulls
+// files from a shared queue. Files with more than two channels are rendered
+// on the matching surround layout (5.1, 7.1, 7.1.4, ...). Each file is
+// written to <out>/<name>.wav; inputs that would share a name, or overwrite
+// one of the inputs, get a -2, -3, ... suffix instead.
+//
+//   KeroRender [--state patch.xml|state.bin] [--out dir] [--block n]
+//              [--threads n] [--bits 16|24|32] [--tail] files...
+
+namespace
+{
+    struct Options
+    {
+        juce::File              stateFile;
+        juce::File              outDir;
+        int                     blockSize  = 8192;
+        int                     threads    = juce::SystemStats::getNumCpus();
+        int                     bits       = 24;
+        bool                    renderTail = false;
+        juce::Array<juce::File> inputs;
+        juce::Array<juce::File> outputs;   // one per input, all distinct
+    };
+
+    struct Totals
+    {
+        std::atomic<int>      next{ 0 };
+        std::atomic<int>      failed{ 0 };
+        std::atomic<int64_t>  samples{ 0 };
+        std::atomic<int64_t>  frames{ 0 };
+        double                audioSeconds = 0.0;
+        juce::CriticalSection lock;
+    };
+
+    void printUsage()
+    {
+        std::cout << "usage: KeroRender [--state patch.xml|state.bin] [--out dir] [--block n]\n"
+                     "                  [--threads n] [--bits 16|24|32] [--tail] files...\n";
+    }
+
+    bool parseArgs(const juce::StringArray& args, Options& o)
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& a = args[i];
+            auto value = [&]() { return i + 1 < args.size() ? args[++i] : juce::String(); };
+
+            if      (a == "--state")   o.stateFile  = juce::File::getCurrentWorkingDirectory().getChildFile(value());
+            else if (a == "--out")     o.outDir     = juce::File::getCurrentWorkingDirectory().getChildFile(value());
+            else if (a == "--block")   o.blockSize  = juce::jlimit(16, 1 << 16, value().getIntValue());
+            else if (a == "--threads") o.threads    = juce::jmax(1, value().getIntValue());
+            else if (a == "--bits")    o.bits       = value().getIntValue();
+            else if (a == "--tail")    o.renderTail = true;
+            else if (a.startsWith("--")) return false;
+            else o.inputs.add(juce::File::getCurrentWorkingDirectory().getChildFile(a));
+        }
+
+        if (o.outDir == juce::File())
+            o.outDir = juce::File::getCurrentWorkingDirectory().getChildFile("rendered");
+        if (o.bits != 16 && o.bits != 24 && o.bits != 32) o.bits = 24;
+        return !o.inputs.isEmpty();
+    }
+
+    // Names are compared ignoring case, as the file system may.
+    void assignOutputs(Options& o)
+    {
+        std::set<juce::String> taken;
+        for (auto& f : o.inputs) taken.insert(f.getFullPathName().toLowerCase());
+
+        for (auto& in : o.inputs)
+        {
+            const auto base = in.getFileNameWithoutExtension();
+            auto out = o.outDir.getChildFile(base + ".wav");
+            for (int n = 2; taken.count(out.getFullPathName().toLowerCase()) > 0; ++n)
+                out = o.outDir.getChildFile(base + "-" + juce::String(n) + ".wav");
+
+            if (out.getFileNameWithoutExtension() != base)
+                std::cout << in.getFullPathName() << " -> " << out.getFileName() << " (name already used)\n";
+
+            taken.insert(out.getFullPathName().toLowerCase());
+            o.outputs.add(out);
+        }
+    }
+
+    // Patch XML (as saved by savePatch) or a raw getStateInformation blob.
+    bool loadState(const juce::File& f, juce::MemoryBlock& dest)
+    {
+        if (f == juce::File()) return true;
+        if (!f.existsAsFile()) return false;
+
+        if (f.hasFileExtension("xml"))
+        {
+            auto xml = juce::XmlDocument::parse(f);
+            if (!xml) return false;
+            juce::AudioProcessor::copyXmlToBinary(*xml, dest);
+            return true;
+        }
+        return f.loadFileAsData(dest);
+    }
+
+    // ── Worker ───────────────────────────────────────────────────────────────
+    class RenderWorker : public juce::ThreadPoolJob
+    {
+    public:
+        RenderWorker(const Options& o, const juce::MemoryBlock& s, Totals& t)
+            : juce::ThreadPoolJob("KeroRender"), opts(o), state(s), totals(t)
+        {
+            formats.registerBasicFormats();
+        }
+
+        JobStatus runJob() override
+        {
+            KeroMixAIAudioProcessor proc;
+            if (state.getSize() > 0)
+                proc.setStateInformation(state.getData(), (int)state.getSize());
+            proc.setNonRealtime(true);
+
+            for (;;)
+            {
+                const int idx = totals.next++;
+                if (idx >= opts.inputs.size() || shouldExit()) break;
+                if (!renderFile(proc, opts.inputs[idx], opts.outputs[idx])) ++totals.failed;
+            }
+            return jobHasFinished;
+        }
+
+    private:
+        bool renderFile(KeroMixAIAudioProcessor& proc, const juce::File& in, const juce::File& out)
+        {
+            std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(in));
+            if (!reader)
+            {
+                log("cannot read " + in.getFullPathName());
+                return false;
+            }
+
+            const double sr    = reader->sampleRate;
+            const int    numCh = juce::jlimit(1, BusRouting::MAX_CHANNELS, (int)reader->numChannels);
+            const int    block = opts.blockSize;
+
+            juce::AudioProcessor::BusesLayout layout;
+            const auto set = BusRouting::getDefaultLayout(numCh);
+            layout.inputBuses.add(set);
+            layout.outputBuses.add(set);
+            if (!proc.setBusesLayout(layout))
+            {
+                log("unsupported layout for " + in.getFileName());
+                return false;
+            }
+
+            proc.setRateAndBufferSizeDetails(sr, block);
+            proc.prepareToPlay(sr, block);
+
+            out.deleteFile();
+            std::unique_ptr<juce::OutputStream> stream(out.createOutputStream());
+            std::unique_ptr<juce::AudioFormatWriter> writer;
+            if (stream)
+                writer.reset(juce::WavAudioFormat().createWriterFor(stream.get(), sr, (unsigned)numCh,
+                                                                   opts.bits, {}, 0));
+            if (!writer)
+            {
+                log("cannot write " + out.getFullPathName());
+                return false;
+            }
+            stream.release();   // owned by the writer now
+
+            // Output is shifted by the reported latency so it lines up with the input.
+            const int64_t inLen   = reader->lengthInSamples;
+            const int64_t tail    = opts.renderTail ? (int64_t)(proc.getTailLengthSeconds() * sr) : 0;
+            const int64_t outLen  = inLen + tail;
+            int64_t       toSkip  = proc.getLatencySamples();
+            const int64_t total   = outLen + toSkip;
+
+            juce::AudioBuffer<float> buffer(numCh, block);
+            juce::MidiBuffer midi;
+            const auto start = juce::Time::getMillisecondCounterHiRes();
+
+            for (int64_t pos = 0; pos < total; pos += block)
+            {
+                const int n = (int)juce::jmin<int64_t>(block, total - pos);
+                buffer.setSize(numCh, n, false, false, true);
+                buffer.clear();
+                if (pos < inLen)
+                    reader->read(&buffer, 0, (int)juce::jmin<int64_t>(n, inLen - pos), pos, true, numCh >= 2);
+
+                proc.processBlock(buffer, midi);
+
+                const int skip = (int)juce::jmin<int64_t>(toSkip, n);
+                toSkip -= skip;
+                if (n > skip) writer->writeFromAudioSampleBuffer(buffer, skip, n - skip);
+            }
+
+            proc.releaseResources();
+            writer.reset();
+
+            const double secs = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+            totals.frames  += outLen;
+            totals.samples += outLen * numCh;
+            {
+                juce::ScopedLock sl(totals.lock);
+                totals.audioSeconds += (double)outLen / sr;
+            }
+            log(in.getFileName() + ": " + juce::String((double)outLen / sr, 2) + " s in "
+                + juce::String(secs, 3) + " s (" + juce::String((double)outLen / sr / juce::jmax(1e-9, secs), 1)
+                + "x realtime)");
+            return true;
+        }
+
+        void log(const juce::String& msg)
+        {
+            juce::ScopedLock sl(totals.lock);
+            std::cout << msg << std::endl;
+        }
+
+        const Options&           opts;
+        const juce::MemoryBlock& state;
+        Totals&                  totals;
+        juce::AudioFormatManager formats;
+    };
+}
+
+// ── Main ─────────────────────────────────────────────────────────────────────
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i) args.add(juce::CharPointer_UTF8(argv[i]));
+
+    Options opts;
+    if (!parseArgs(args, opts)) { printUsage(); return 1; }
+
+    juce::MemoryBlock state;
+    if (!loadState(opts.stateFile, state))
+    {
+        std::cerr << "cannot load state " << opts.stateFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    if (!opts.outDir.createDirectory())
+    {
+        std::cerr << "cannot create " << opts.outDir.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    assignOutputs(opts);
+
+    Totals totals;
+    const int numWorkers = juce::jmin(opts.threads, opts.inputs.size());
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+    {
+        juce::ThreadPool pool(numWorkers);
+        for (int i = 0; i < numWorkers; ++i)
+            pool.addJob(new RenderWorker(opts, state, totals), true);
+
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep(20);
+    }
+    const double secs = juce::jmax(1e-9, (juce::Time::getMillisecondCounterHiRes() - start) * 0.001);
+
+    std::cout << "rendered " << (opts.inputs.size() - totals.failed.load()) << "/" << opts.inputs.size()
+              << " files on " << numWorkers << " threads in " << juce::String(secs, 2) << " s: "
+              << (juce::int64)((double)totals.samples.load() / secs) << " samples/s ("
+              << (juce::int64)((double)totals.frames.load() / secs) << " frames/s, "
+              << juce::String(totals.audioSeconds / secs, 1) << "x realtime)" << std::endl;
+
+    return totals.failed.load() == 0 ? 0 : 2;
+}
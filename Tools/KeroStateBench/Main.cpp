@@ -0,0 +1,282 @@
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+// ─── KeroStateBench ──────────────────────────────────────────────────────────
+// Session save / load cost per plugin instance. Builds --instances
+// processors with a non-default mix and a before/after morph, then times
+// getStateInformation and setStateInformation on every instance, round after
+// round. Formats:
+//   binary   the StateCodec format sessions are written in now
+//   xml      the ValueTree -> XML -> copyXmlToBinary path used before it,
+//            loaded with replaceState as it was
+//   compat   the xml blobs above loaded through setStateInformation, as
+//            old sessions are
+// Before timing anything it checks that states survive the round trip:
+// values, IR path and morph states through the binary format, an old XML
+// blob, a blob with an unknown chunk appended, and truncated blobs, which
+// must leave the instance untouched. A mismatch exits with status 2.
+//
+//   KeroStateBench [--instances n] [--rounds n] [--json out.json] [--label text]
+
+namespace
+{
+    using Proc = KeroMixAIAudioProcessor;
+
+    enum class Format { binary, xml, compat };
+    const char* getFormatName(Format f)
+    {
+        switch (f)
+        {
+            case Format::binary: return "binary";
+            case Format::xml:    return "xml";
+            case Format::compat: return "compat";
+        }
+        return "";
+    }
+
+    void setUpInstance(Proc& proc, int index)
+    {
+        const std::pair<const char*, float> values[] = {
+            { "lowG", 3.f }, { "midFreq", 1800.f }, { "highG", -2.f }, { "compThresh", -20.f },
+            { "compRatio", 6.f }, { "delayMix", 0.2f }, { "revMix", 0.15f } };
+
+        const auto before = proc.captureState();
+        for (auto& [id, v] : values)
+            if (auto* r = proc.apvts.getParameter(id))
+                r->setValueNotifyingHost(r->convertTo0to1(v + 0.01f * (float)(index % 7)));
+        proc.setMorphStates({ before, proc.captureState() });
+    }
+
+    void saveXml(Proc& proc, juce::MemoryBlock& dest)
+    {
+        auto state = proc.apvts.copyState();
+        std::unique_ptr<juce::XmlElement> xml(state.createXml());
+        juce::AudioProcessor::copyXmlToBinary(*xml, dest);
+    }
+
+    void loadXml(Proc& proc, const juce::MemoryBlock& src)
+    {
+        std::unique_ptr<juce::XmlElement> xml(juce::AudioProcessor::getXmlFromBinary(src.getData(), (int)src.getSize()));
+        if (xml && xml->hasTagName(proc.apvts.state.getType()))
+            proc.apvts.replaceState(juce::ValueTree::fromXml(*xml));
+    }
+
+    // ── Round trip ───────────────────────────────────────────────────────────
+    StateCodec::State decode(Proc& proc)
+    {
+        juce::MemoryBlock blob;
+        proc.getStateInformation(blob);
+        StateCodec::State state;
+        StateCodec::read(blob.getData(), blob.getSize(), state);
+        return state;
+    }
+
+    // Empty when `actual` matches; values may differ by float rounding
+    // through the normalised range.
+    juce::String compare(const StateCodec::State& expected, const StateCodec::State& actual, bool withMorph)
+    {
+        for (int i = 0; i < ParameterSnapshot::NUM_IDS; ++i)
+        {
+            const float a = expected.values[i], b = actual.values[i];
+            if (std::isnan(a) != std::isnan(b) || std::abs(a - b) > 1e-5f * (1.f + std::abs(a)))
+                return juce::String(ParameterSnapshot::paramIDs[i]) + " is " + juce::String(b)
+                       + ", expected " + juce::String(a);
+        }
+        if (actual.irPath != expected.irPath)
+            return "irPath is \"" + actual.irPath + "\", expected \"" + expected.irPath + "\"";
+        if (withMorph && actual.morphStates != expected.morphStates)
+            return juce::String((int)actual.morphStates.size()) + " morph states differ from the "
+                   + juce::String((int)expected.morphStates.size()) + " saved";
+        return {};
+    }
+
+    bool verifyRoundTrip()
+    {
+        Proc source, other, target;
+        setUpInstance(source, 3);
+        setUpInstance(other, 5);
+        source.apvts.state.setProperty("irPath", "/KeroStateBench/missing-ir.wav", nullptr);
+
+        const auto expected = decode(source);
+        juce::MemoryBlock binary, xml, otherBinary;
+        source.getStateInformation(binary);
+        saveXml(source, xml);
+        other.getStateInformation(otherBinary);
+
+        juce::MemoryOutputStream withChunk;
+        withChunk.write(binary.getData(), binary.getSize());
+        withChunk.writeInt(0x5a5a5a5a);   // "ZZZZ", unknown to every reader
+        withChunk.writeInt(4);
+        withChunk.writeInt(12345);
+
+        bool ok = true;
+        auto check = [&](const char* name, const void* data, size_t size, bool withMorph)
+            {
+                target.setStateInformation(data, (int)size);
+                const auto error = compare(expected, decode(target), withMorph);
+                if (error.isNotEmpty())
+                {
+                    std::cerr << "round trip " << name << ": " << error << std::endl;
+                    ok = false;
+                }
+            };
+
+        check("binary", binary.getData(), binary.getSize(), true);
+        check("xml", xml.getData(), xml.getSize(), false);
+        check("unknown chunk", withChunk.getData(), withChunk.getDataSize(), true);
+
+        // Rejected as a whole: `target` keeps the source state loaded above.
+        const auto* bytes     = static_cast<const char*>(otherBinary.getData());
+        const size_t paramEnd = 12 + 6 * (size_t)juce::ByteOrder::littleEndianShort(bytes + 8);
+        check("truncated header", bytes, 6, true);
+        check("truncated params", bytes, paramEnd - 1, true);
+        check("truncated chunk header", bytes, paramEnd + 5, true);
+        check("truncated chunk", bytes, otherBinary.getSize() - 3, true);
+        return ok;
+    }
+
+    // ── Timing ───────────────────────────────────────────────────────────────
+    struct Stats
+    {
+        Format              format;
+        std::vector<double> saveUs, loadUs;
+        size_t              bytes = 0;
+
+        static double percentile(const std::vector<double>& sorted, double q)
+        {
+            if (sorted.empty()) return 0.0;
+            const auto i = (size_t)juce::jlimit(0, (int)sorted.size() - 1, (int)std::ceil(q * (double)sorted.size()) - 1);
+            return sorted[i];
+        }
+
+        static double mean(const std::vector<double>& v)
+        {
+            return v.empty() ? 0.0 : std::accumulate(v.begin(), v.end(), 0.0) / (double)v.size();
+        }
+    };
+
+    double ticksToUs(juce::int64 ticks) { return juce::Time::highResolutionTicksToSeconds(ticks) * 1e6; }
+
+    Stats run(Format format, std::vector<std::unique_ptr<Proc>>& procs, int rounds)
+    {
+        Stats stats{ format };
+        std::vector<juce::MemoryBlock> blobs(procs.size());
+
+        for (int round = 0; round < rounds; ++round)
+        {
+            for (size_t i = 0; i < procs.size(); ++i)
+            {
+                const auto t0 = juce::Time::getHighResolutionTicks();
+                if (format == Format::binary) procs[i]->getStateInformation(blobs[i]);
+                else                          saveXml(*procs[i], blobs[i]);
+                stats.saveUs.push_back(ticksToUs(juce::Time::getHighResolutionTicks() - t0));
+            }
+
+            for (size_t i = 0; i < procs.size(); ++i)
+            {
+                const auto t0 = juce::Time::getHighResolutionTicks();
+                if (format == Format::xml) loadXml(*procs[i], blobs[i]);
+                else                       procs[i]->setStateInformation(blobs[i].getData(), (int)blobs[i].getSize());
+                stats.loadUs.push_back(ticksToUs(juce::Time::getHighResolutionTicks() - t0));
+            }
+        }
+
+        for (auto& b : blobs) stats.bytes += b.getSize();
+        stats.bytes /= juce::jmax((size_t)1, blobs.size());
+
+        std::sort(stats.saveUs.begin(), stats.saveUs.end());
+        std::sort(stats.loadUs.begin(), stats.loadUs.end());
+        return stats;
+    }
+
+    // ── Output ───────────────────────────────────────────────────────────────
+    void printStats(const Stats& s)
+    {
+        juce::String line;
+        line << juce::String(getFormatName(s.format)).paddedRight(' ', 8)
+             << juce::String((int)s.bytes).paddedLeft(' ', 7) << " |";
+        for (auto* v : { &s.saveUs, &s.loadUs })
+        {
+            line << juce::String(Stats::mean(*v), 2).paddedLeft(' ', 9)
+                 << juce::String(Stats::percentile(*v, 0.5), 2).paddedLeft(' ', 9)
+                 << juce::String(Stats::percentile(*v, 0.99), 2).paddedLeft(' ', 9) << " |";
+        }
+        std::cout << line << std::endl;
+    }
+
+    juce::var toVar(const Stats& s)
+    {
+        auto* o = new juce::DynamicObject();
+        o->setProperty("format", getFormatName(s.format));
+        o->setProperty("bytes", (int)s.bytes);
+        o->setProperty("save_us_mean", Stats::mean(s.saveUs));
+        o->setProperty("save_us_p50", Stats::percentile(s.saveUs, 0.5));
+        o->setProperty("save_us_p99", Stats::percentile(s.saveUs, 0.99));
+        o->setProperty("load_us_mean", Stats::mean(s.loadUs));
+        o->setProperty("load_us_p50", Stats::percentile(s.loadUs, 0.5));
+        o->setProperty("load_us_p99", Stats::percentile(s.loadUs, 0.99));
+        return juce::var(o);
+    }
+}
+
+// ── Main ─────────────────────────────────────────────────────────────────────
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i) args.add(juce::CharPointer_UTF8(argv[i]));
+
+    int          instances = 100, rounds = 20;
+    juce::String label;
+    juce::File   jsonFile;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        auto value = [&]() { return i + 1 < args.size() ? args[++i] : juce::String(); };
+        if      (args[i] == "--instances") instances = juce::jmax(1, value().getIntValue());
+        else if (args[i] == "--rounds")    rounds    = juce::jmax(1, value().getIntValue());
+        else if (args[i] == "--label")     label     = value();
+        else if (args[i] == "--json")      jsonFile  = juce::File::getCurrentWorkingDirectory().getChildFile(value());
+        else
+        {
+            std::cout << "usage: KeroStateBench [--instances n] [--rounds n] [--json out.json] [--label text]\n";
+            return 1;
+        }
+    }
+
+    if (!verifyRoundTrip()) return 2;
+
+    std::vector<std::unique_ptr<Proc>> procs;
+    for (int i = 0; i < instances; ++i)
+    {
+        procs.push_back(std::make_unique<Proc>());
+        setUpInstance(*procs.back(), i);
+    }
+
+    std::cout << instances << " instances, " << rounds << " rounds\n"
+              << "format    bytes |  save us      p50      p99 |  load us      p50      p99 |" << std::endl;
+
+    juce::Array<juce::var> results;
+    for (auto format : { Format::binary, Format::xml, Format::compat })
+    {
+        const auto stats = run(format, procs, rounds);
+        printStats(stats);
+        results.add(toVar(stats));
+    }
+
+    if (jsonFile != juce::File())
+    {
+        auto* root = new juce::DynamicObject();
+        root->setProperty("label", label);
+        root->setProperty("instances", instances);
+        root->setProperty("rounds", rounds);
+        root->setProperty("results", results);
+        if (!jsonFile.replaceWithText(juce::JSON::toString(juce::var(root))))
+        {
+            std::cerr << "cannot write " << jsonFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}